@@ -11,9 +11,11 @@ int main() {
   using namespace std;
 
   uformat::fixed_texter texter;
+  uformat::long_texter long_texter;
   char charz[256];
+  char long_charz[1024];
 
-  auto const texter_char = ubench::run([&]{ texter.print('a'); });
+  auto const texter_char = ubench::run([&]{ texter.clear(); texter.print('a'); });
   auto const snprintf_char = ubench::run([&]{ snprintf(charz, sizeof (charz), "%c", 'a'); });
   auto const fmt_char = ubench::run([&]{ fmt::format_to(charz, "{}", 'a'); });
 
@@ -22,7 +24,7 @@ int main() {
   cout << "fmt::format(char)  - " << fmt_char << endl;
   cout << endl;
 
-  auto const texter_literal = ubench::run([&]{ texter.print("some literal"); });
+  auto const texter_literal = ubench::run([&]{ texter.clear(); texter.print("some literal"); });
   auto const snprintf_literal = ubench::run([&]{ snprintf(charz, sizeof (charz), "%s", "some literal"); });
   auto const fmt_literal = ubench::run([&]{ fmt::format_to(charz, "{}", "some literal"); });
 
@@ -32,7 +34,7 @@ int main() {
   cout << endl;
 
   char const* benchmark = "benchmark";
-  auto const texter_chars = ubench::run([&]{ texter.print(benchmark); });
+  auto const texter_chars = ubench::run([&]{ texter.clear(); texter.print(benchmark); });
   auto const snprintf_chars = ubench::run([&]{ snprintf(charz, sizeof (charz), "%s", benchmark); });
   auto const fmt_chars = ubench::run([&]{ fmt::format_to(charz, "{}", benchmark); });
 
@@ -41,7 +43,7 @@ int main() {
   cout << "fmt::format(char*)  - " << fmt_chars << endl;
   cout << endl;
 
-  auto const texter_int = ubench::run([&]{ texter.print(-127562); });
+  auto const texter_int = ubench::run([&]{ texter.clear(); texter.print(-127562); });
   auto const snprintf_int = ubench::run([&]{ snprintf(charz, sizeof (charz), "%d", -127562); });
   auto const fmt_int = ubench::run([&]{ fmt::format_to(charz, "{}", -127562); });
 
@@ -50,7 +52,7 @@ int main() {
   cout << "fmt::format(int)  - " << fmt_int << endl;
   cout << endl;
 
-  auto const texter_double = ubench::run([&]{ texter.print(-127562.127562); });
+  auto const texter_double = ubench::run([&]{ texter.clear(); texter.print(-127562.127562); });
   auto const snprintf_double = ubench::run([&]{ snprintf(charz, sizeof (charz), "%f", -127562.127562); });
   auto const fmt_double = ubench::run([&]{ fmt::format_to(charz, "{}", -127562.127562); });
 
@@ -59,6 +61,52 @@ int main() {
   cout << "fmt::format(double)  - " << fmt_double << endl;
   cout << endl;
 
+  auto const texter_large = ubench::run([&]{ long_texter.clear(); long_texter.print(-1.5e300); });
+  auto const snprintf_large = ubench::run([&]{ snprintf(long_charz, sizeof (long_charz), "%f", -1.5e300); });
+  auto const fmt_large = ubench::run([&]{ fmt::format_to(long_charz, "{:f}", -1.5e300); });
+
+  cout << "texter.print(large double) - " << texter_large << endl;
+  cout << "snprintf(large double)     - " << snprintf_large << endl;
+  cout << "fmt::format(large double)  - " << fmt_large << endl;
+  cout << endl;
+
+  auto const texter_shortest = ubench::run([&]{ texter.clear(); texter.shortest(-127562.127562); });
+  auto const snprintf_shortest = ubench::run([&]{ snprintf(charz, sizeof (charz), "%.17g", -127562.127562); });
+  auto const fmt_shortest = ubench::run([&]{ fmt::format_to(charz, "{}", -127562.127562); });
+
+  cout << "texter.shortest(double) - " << texter_shortest << endl;
+  cout << "snprintf(double)        - " << snprintf_shortest << endl;
+  cout << "fmt::format(double)     - " << fmt_shortest << endl;
+  cout << endl;
+
+  auto const texter_line = ubench::run([&]{ texter.clear(); texter.print("order ", 1500, " side=", 'B', " px=", 1.2345, " qty=", 100u, " flag=", true); });
+  auto const snprintf_line = ubench::run([&]{ snprintf(charz, sizeof (charz), "order %d side=%c px=%f qty=%u flag=%s", 1500, 'B', 1.2345, 100u, "true"); });
+  auto const fmt_line = ubench::run([&]{ fmt::format_to(charz, "order {} side={} px={:f} qty={} flag={}", 1500, 'B', 1.2345, 100u, true); });
+
+  cout << "texter.print(10 fields) - " << texter_line << endl;
+  cout << "snprintf(10 fields)     - " << snprintf_line << endl;
+  cout << "fmt::format(10 fields)  - " << fmt_line << endl;
+  cout << endl;
+
+  // Grows without zero filling only when built with C++23
+  // (__cpp_lib_string_resize_and_overwrite), measures resize() otherwise
+  uformat::dynamic_texter dynamic_texter;
+  auto const dynamic_line = ubench::run([&]{ dynamic_texter.clear(); dynamic_texter.print("order ", 1500, " side=", 'B', " px=", 1.2345, " qty=", 100u, " flag=", true); });
+
+  cout << "dynamic_texter.print(10 fields) - " << dynamic_line << endl;
+  cout << "texter.print(10 fields)         - " << texter_line << endl;
+  cout << endl;
+
+  double const px = 1.2345678;
+  int const qty = 1500;
+  auto const texter_format = ubench::run([&]{ texter.clear(); texter.format<"px={:.4f} qty={:>8}">(px, qty); });
+  auto const snprintf_format = ubench::run([&]{ snprintf(charz, sizeof (charz), "px=%.4f qty=%8d", px, qty); });
+  auto const fmt_format = ubench::run([&]{ fmt::format_to(charz, "px={:.4f} qty={:>8}", px, qty); });
+
+  cout << "texter.format<...>(double, int) - " << texter_format << endl;
+  cout << "snprintf(double, int)           - " << snprintf_format << endl;
+  cout << "fmt::format(double, int)        - " << fmt_format << endl;
+  cout << endl;
 
   return 0;
 }
@@ -0,0 +1,257 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "texter.hpp"
+#include "output.hpp"
+
+
+namespace uformat {
+
+
+  // Producers format lines into slots of bounded lock-free MPSC ring
+  // (D. Vyukov's bounded queue), writer thread drains it and writes
+  // lines in large batches
+  class async_logger {
+  public:
+
+    using size_type = size_t;
+
+    static constexpr size_type default_capacity = 4096;
+    static constexpr size_type batch_size = 65536;
+
+
+    explicit async_logger(overflow policy = overflow::block,
+                          size_type capacity = default_capacity,
+                          std::FILE* out = stdout, std::FILE* err = stderr):
+      policy_{policy},
+      mask_{round_capacity(capacity) - 1},
+      slots_{new slot[mask_ + 1]},
+      out_{detail::output::descriptor(out)},
+      err_{detail::output::descriptor(err)} {
+      for(size_type i = 0; i != mask_ + 1; ++i)
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+      writer_ = std::thread{[this]{ drain(); }};
+    }
+
+
+    async_logger(async_logger const&) = delete;
+    async_logger& operator = (async_logger const&) = delete;
+
+
+    ~async_logger() {
+      {
+        std::unique_lock g{sync_};
+        stopping_.store(true, std::memory_order_release);
+      }
+      wakeup_.notify_one();
+      writer_.join();
+    }
+
+
+    overflow policy() const noexcept { return policy_; }
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+
+    // Lines dropped with overflow::drop_and_count
+    uint64_t dropped() const noexcept {
+      return dropped_.load(std::memory_order_relaxed);
+    }
+
+
+    // Returns false when line was dropped
+    template<typename... Args>
+    bool print(Args&&... args) {
+      return push(out_, std::forward<Args>(args)...);
+    }
+
+
+    template<typename R, typename... Args>
+    R print_with(R&& result, Args&&... args) {
+      print(std::forward<Args>(args)...);
+      return std::move(std::forward<R>(result));
+    }
+
+
+    template<typename... Args>
+    bool error(Args&&... args) {
+      return push(err_, std::forward<Args>(args)...);
+    }
+
+
+    template<typename R, typename... Args>
+    R error_with(R&& result, Args&&... args) {
+      error(std::forward<Args>(args)...);
+      return std::move(std::forward<R>(result));
+    }
+
+
+  private:
+
+    struct alignas(64) slot {
+      std::atomic<size_type> sequence;
+      int descriptor;
+      dynamic_texter line;
+    };
+
+    overflow const policy_;
+    size_type const mask_;
+    std::unique_ptr<slot[]> slots_;
+    int const out_;
+    int const err_;
+    alignas(64) std::atomic<size_type> enqueue_position_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stopping_{false};
+    std::mutex sync_;
+    std::condition_variable wakeup_;
+    std::thread writer_;
+
+
+    static size_type round_capacity(size_type n) {
+      size_type capacity = 2;
+      while(capacity < n)
+        capacity <<= 1;
+      return capacity;
+    }
+
+
+    template<typename... Args>
+    bool push(int descriptor, Args&&... args) {
+      size_type position;
+      slot* s = acquire(position);
+      if(s == nullptr)
+        return false;
+      s->descriptor = descriptor;
+      s->line.clear();
+      try {
+        s->line.print(std::forward<Args>(args)..., '\n');
+      } catch(...) {
+        // Acquired slot is published empty, otherwise writer stalls on it
+        s->line.clear();
+        publish(*s, position);
+        throw;
+      }
+      publish(*s, position);
+      return true;
+    }
+
+
+    // Store of sequence and load of sleeping_ pair with writer's store of
+    // sleeping_ and load of sequence, so both sides need seq_cst fences.
+    // Locking sync_ ensures writer is already waiting when notified
+    void publish(slot& s, size_type position) {
+      s.sequence.store(position + 1, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(!sleeping_.load(std::memory_order_relaxed))
+        return;
+      { std::lock_guard g{sync_}; }
+      wakeup_.notify_one();
+    }
+
+
+    slot* acquire(size_type& position) {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+      for(;;) {
+        slot& s = slots_[position & mask_];
+        size_type const sequence = s.sequence.load(std::memory_order_acquire);
+        auto const difference = intptr_t(sequence) - intptr_t(position);
+        if(difference == 0) {
+          if(enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed))
+            return &s;
+        } else if(difference < 0) {
+          switch(policy_) {
+          case overflow::block:
+            std::this_thread::yield();
+            position = enqueue_position_.load(std::memory_order_relaxed);
+            break;
+          case overflow::drop_and_count:
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+          default:
+            return nullptr;
+          }
+        } else {
+          position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+
+    void drain() {
+      dynamic_texter batch;
+      batch.reserve(batch_size);
+      int batch_descriptor = out_;
+      size_type position = 0;
+
+      for(;;) {
+        slot& s = slots_[position & mask_];
+        if(s.sequence.load(std::memory_order_acquire) == position + 1) {
+          // Line is empty when its formatting has thrown
+          if(!s.line.empty()) {
+            if(s.descriptor != batch_descriptor || batch.size() >= batch_size) {
+              flush(batch_descriptor, batch);
+              batch_descriptor = s.descriptor;
+            }
+            batch << s.line;
+          }
+          s.sequence.store(position + mask_ + 1, std::memory_order_release);
+          ++position;
+          continue;
+        }
+
+        flush(batch_descriptor, batch);
+        if(stopping_.load(std::memory_order_acquire)
+           && enqueue_position_.load(std::memory_order_acquire) == position)
+          return;
+
+        std::unique_lock g{sync_};
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(s.sequence.load(std::memory_order_acquire) != position + 1
+           && !stopping_.load(std::memory_order_acquire))
+          wakeup_.wait(g);
+        sleeping_.store(false, std::memory_order_relaxed);
+      }
+    }
+
+
+    static void flush(int descriptor, dynamic_texter& batch) {
+      if(batch.empty())
+        return;
+      detail::output::write(descriptor, batch.data(), batch.size());
+      batch.clear();
+    }
+  }; // async_logger
+
+
+} // uformat
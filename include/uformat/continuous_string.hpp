@@ -1,10 +1,14 @@
 #pragma once
 
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <new>
 #include <string_view>
 #include <string>
 #include <stdexcept>
+#include "search.hpp"
 
 
 #if defined(_WIN32)
@@ -25,6 +29,12 @@
 #include <memoryapi.h>
 #include <handleapi.h>
 
+#elif defined(__unix__) || defined(__APPLE__)
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #else
   
 #error Unsupported system
@@ -34,9 +44,52 @@
 
 
 namespace uformat {
-  
 
-template<std::uint64_t MCAP = 2147483648>
+
+enum class page_policy {
+  standard,          // system page size
+  transparent_huge,  // huge page aligned region advised for transparent huge pages
+  explicit_huge      // huge pages from reserved pool, as transparent_huge if pool is short
+};
+
+
+// File to place continuous_string content to
+struct mapped_file {
+  char const* path;
+};
+
+
+// POSIX shared memory object to place continuous_string content to,
+// readers open it with shared_view
+struct shared_memory {
+  char const* name;
+};
+
+
+namespace detail {
+
+  // First page of shared memory object, content follows it
+  struct shared_header {
+    std::atomic<std::uint64_t> size{0};
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<std::uint64_t> capacity{0};
+    char name[256]{};
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+  };
+
+} // detail
+
+
+// MCAP bytes of address space are reserved and committed on demand,
+// PREFAULT bytes of them are committed and touched on construction,
+// every SHRINK_AFTER clears pages above twice the peak size are decommitted.
+// When construction fails string is not valid(): it stays empty with null
+// data() and every write to it is ignored
+template<std::uint64_t MCAP = 2147483648,
+         page_policy PAGES = page_policy::standard,
+         std::uint64_t PREFAULT = 0,
+         unsigned SHRINK_AFTER = 0>
 class continuous_string {
 public:
 
@@ -55,6 +108,53 @@ public:
   
   continuous_string() noexcept { reserve(); }  
   ~continuous_string() { dispose(); }
+
+
+#if !defined(_WIN32)
+  // Content is written straight to the file mapping, file grows with
+  // commits and is truncated to size on destruction; string is not valid()
+  // when file can't be opened or address space can't be reserved
+  explicit continuous_string(mapped_file const& file) noexcept {
+    descriptor_ = open(file.path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(descriptor_ == -1 || reserve())
+      return;
+    close(descriptor_);
+    descriptor_ = -1;
+  }
+
+
+  // Writer side, readers see content up to size given to last publish().
+  // Writer owns the object: it is created exclusively and unlinked on
+  // destruction, so string is not valid() while other writer holds the name
+  // (or object left by crashed writer is not unlinked yet)
+  explicit continuous_string(shared_memory const& memory) noexcept {
+    auto const name_size = std::strlen(memory.name);
+    if(name_size >= sizeof(detail::shared_header::name))
+      return;
+    descriptor_ = shm_open(memory.name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(descriptor_ == -1)
+      return;
+    auto const page_size = get_page_size();
+    void* header = MAP_FAILED;
+    if(ftruncate(descriptor_, off_t(page_size)) == 0)
+      header = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_, 0);
+    if(header != MAP_FAILED) {
+      header_ = new(header) detail::shared_header{};
+      std::memcpy(header_->name, memory.name, name_size);
+      offset_ = page_size;
+      if(reserve()) {
+        header_->capacity.store(reserved_capacity_, std::memory_order_release);
+        return;
+      }
+      munmap(header, page_size);
+      header_ = nullptr;
+      offset_ = 0;
+    }
+    shm_unlink(memory.name);
+    close(descriptor_);
+    descriptor_ = -1;
+  }
+#endif
   
   
   continuous_string(continuous_string const& other) noexcept {
@@ -68,6 +168,7 @@ public:
   continuous_string& operator = (continuous_string const& other) noexcept {
     if(!commit(other.size_))
       return *this;
+    retract(0);
     std::memcpy(data_, other.data_, other.size_);
     size_ = other.size_;
     return *this;
@@ -76,11 +177,17 @@ public:
   
   continuous_string(continuous_string&& other) noexcept:
     reserved_capacity_{other.reserved_capacity_}, committed_capacity_{other.committed_capacity_},
-    size_{other.size_}, data_{other.data_} {    
+    size_{other.size_}, data_{other.data_}, peak_{other.peak_}, clears_{other.clears_},
+    descriptor_{other.descriptor_}, offset_{other.offset_}, header_{other.header_} {
     other.reserved_capacity_ = 0;
     other.committed_capacity_ = 0;
     other.size_ = 0;
     other.data_ = nullptr;
+    other.peak_ = 0;
+    other.clears_ = 0;
+    other.descriptor_ = -1;
+    other.offset_ = 0;
+    other.header_ = nullptr;
   }
   
   
@@ -90,6 +197,11 @@ public:
     committed_capacity_ = other.committed_capacity_; other.committed_capacity_ = 0;
     size_ = other.size_; other.size_ = 0;
     data_ = other.data_; other.data_ = nullptr;
+    peak_ = other.peak_; other.peak_ = 0;
+    clears_ = other.clears_; other.clears_ = 0;
+    descriptor_ = other.descriptor_; other.descriptor_ = -1;
+    offset_ = other.offset_; other.offset_ = 0;
+    header_ = other.header_; other.header_ = nullptr;
     return *this;
   }
   
@@ -167,8 +279,50 @@ public:
   size_type length() const noexcept { return size_; }
   size_type capacity() const noexcept { return reserved_capacity_ - 1; }
   size_type max_size() const noexcept { return reserved_capacity_ - 1; }
+  size_type committed() const noexcept { return committed_capacity_ - 1; }
   bool empty() const noexcept { return size_ == 0; }
-  void clear() noexcept { size_ = 0; data_[0] = '\0'; }
+
+
+  void clear() noexcept {
+    if constexpr(SHRINK_AFTER != 0) {
+      if(size_ > peak_)
+        peak_ = size_;
+      if(++clears_ == SHRINK_AFTER) {
+        decommit(2 * nearest_power_of_2(peak_ + 1));
+        peak_ = 0;
+        clears_ = 0;
+      }
+    }
+    restart();
+  }
+
+
+  void shrink_to_fit() noexcept {
+    decommit(nearest_power_of_2(size_ + 1));
+  }
+
+
+  bool valid() const noexcept { return data_ != nullptr; }
+  bool mapped() const noexcept { return descriptor_ != -1; }
+
+
+  // Makes content visible to shared_view readers, no system calls
+  void publish() noexcept {
+    if(header_ != nullptr)
+      header_->size.store(size_, std::memory_order_release);
+  }
+
+
+  // Writes mapped file content through to disk
+  bool sync() const noexcept {
+#if defined(_WIN32)
+    return true;
+#else
+    if(descriptor_ == -1)
+      return true;
+    return msync(data_, committed_capacity_, MS_SYNC) == 0;
+#endif
+  }
   
   
   bool reserve(size_type new_capacity) noexcept {
@@ -185,8 +339,7 @@ public:
     if(new_capacity > reserved_capacity_)
       return false;
     
-    auto committed = commit_pages(&data_[committed_capacity_],
-                                new_capacity - committed_capacity_);
+    auto committed = commit_range(data_, committed_capacity_, new_capacity);
     if(committed == nullptr)
       return false;
     
@@ -199,6 +352,7 @@ public:
     if(n + 1 > committed_capacity_)
       if(!reserve(n))
         return false;
+    retract(n);
     size_ = n;
     data_[n] = '\0';
     return true;
@@ -283,12 +437,7 @@ public:
   continuous_string& append(char const* cc) noexcept {
     if(cc == nullptr)
       return *this;
-    while(*cc != '\0') {
-      if(!push_back(*cc))
-        return *this;
-      ++cc;
-    }
-    return *this;
+    return append(cc, cc + std::strlen(cc));
   }
 
   continuous_string& append(wchar_t const* cc) noexcept {
@@ -303,21 +452,21 @@ public:
   }
 
   continuous_string& append(char const* b, char const* e) noexcept {
-    if(b == nullptr || e == nullptr || b == e)
+    if(b == nullptr || e == nullptr || b == e || data_ == nullptr)
       return *this;
     size_type const size_to_append = static_cast<size_type>(e - b);
     if(size_to_append > committed_capacity_ - size_ - 1 
        && !commit(committed_capacity_ + size_to_append))
-      return *this;      
-    for(char* p = data_ + size_; b != e; ++p, ++b)
-      *p = *b;
+      return *this;
+    // source may be inside this string when assigning
+    std::memmove(data_ + size_, b, size_to_append);
     size_ += size_to_append;
     data_[size_] = '\0';
     return *this;
   }
 
   continuous_string& append(wchar_t const* b, wchar_t const* e) noexcept {
-    if(b == nullptr || e == nullptr || b == e)
+    if(b == nullptr || e == nullptr || b == e || data_ == nullptr)
       return *this;
     size_type const size_to_append = static_cast<size_type>(e - b);
     if(size_to_append > committed_capacity_ - size_ - 1 
@@ -332,6 +481,8 @@ public:
   }
 
   bool push_back(char c) noexcept {
+    if(data_ == nullptr)
+      return false;
     if(size_ + 1 == committed_capacity_ && !commit(committed_capacity_ + 1))
       return false;
     data_[size_] = c;
@@ -341,6 +492,8 @@ public:
   
   
   bool push_back(wchar_t c) noexcept {
+    if(data_ == nullptr)
+      return false;
     if(size_ + 1 == committed_capacity_ && !commit(committed_capacity_ + 1))
       return false;
     // TODO: utf-8 conversion
@@ -352,7 +505,8 @@ public:
   
   void pop_back() noexcept {
     if(size_ == 0) return;
-    data_[--size_] = '\0';
+    retract(--size_);
+    data_[size_] = '\0';
   }
 
 
@@ -372,25 +526,25 @@ public:
 
 
   continuous_string& assign(char const* data) noexcept {
-    size_ = 0; data_[0] = '\0';
+    restart();
     return append(data);
   }
 
 
   continuous_string& assign(wchar_t const* data) noexcept {
-    size_ = 0; data_[0] = '\0';
+    restart();
     return append(data);
   }
 
 
   continuous_string& assign(char const* b, char const* e) noexcept {
-    size_ = 0; data_[0] = '\0';
+    restart();
     return append(b, e);
   }
 
 
   continuous_string& assign(wchar_t const* b, wchar_t const* e) noexcept {
-    size_ = 0; data_[0] = '\0';
+    restart();
     return append(b, e);
   }
   
@@ -398,31 +552,61 @@ public:
   char const* c_str() const noexcept { return data_; }
   char const* data() const noexcept { return data_; }
 
+  size_type find(char c, size_type i = 0) const noexcept {
+    if(i >= size_)
+      return npos;
+    return position(detail::find_char(data_ + i, data_ + size_, c));
+  }
+
+
+  size_type find(std::string_view s, size_type i = 0) const noexcept {
+    if(i > size_)
+      return npos;
+    if(s.empty())
+      return i;
+    return position(detail::find_substring(data_ + i, data_ + size_, s));
+  }
+
+
+  size_type rfind(char c, size_type i = npos) const noexcept {
+    if(size_ == 0)
+      return npos;
+    size_type const e = i >= size_ ? size_ : i + 1;
+    return position(detail::rfind_char(data_, data_ + e, c));
+  }
+
+
   size_type find_first_of(char c) const noexcept {
-    return find_first_of(c, 0);
+    return find(c, 0);
   }
 
 
   size_type find_first_of(char c, size_type i) const noexcept {
+    return find(c, i);
+  }
+
+
+  size_type find_first_of(std::string_view set, size_type i = 0) const noexcept {
     if(i >= size_)
       return npos;
-    for(char const *p = data_ + i, *e = data_ + size_; p != e; ++p)
-      if(*p == c)
-        return static_cast<size_type>(p - data_);
-    return npos;
+    return position(detail::find_of(data_ + i, data_ + size_, set, true));
+  }
+
+
+  size_type find_first_not_of(std::string_view set, size_type i = 0) const noexcept {
+    if(i >= size_)
+      return npos;
+    return position(detail::find_of(data_ + i, data_ + size_, set, false));
   }
 
 
   size_type find_last_of(char c) const noexcept {
-    return find_last_of(c, size_ - 1);
+    return rfind(c, npos);
   }
 
 
   size_type find_last_of(char c, size_type i) const noexcept {
-    for(char const* p = data_ + i; p != data_ - 1; --p)
-      if(*p == c)
-        return static_cast<size_type>(p - data_);
-    return npos;
+    return rfind(c, i);
   }
   
   
@@ -477,6 +661,36 @@ private:
   size_type committed_capacity_{0};
   size_type size_{0};
   char* data_{nullptr};
+  size_type peak_{0};
+  unsigned clears_{0};
+  int descriptor_{-1};
+  size_type offset_{0};
+  detail::shared_header* header_{nullptr};
+  
+  
+  void restart() noexcept {
+    retract(0);
+    size_ = 0;
+    if(data_ != nullptr)
+      data_[0] = '\0';
+  }
+
+
+  // Seqlock writer side: bytes below published size are about to be
+  // overwritten, so epoch is bumped before any of them. Reader that
+  // copies some new byte sees new epoch after its acquire fence
+  void retract(size_type n) noexcept {
+    if(header_ == nullptr || n >= header_->size.load(std::memory_order_relaxed))
+      return;
+    header_->size.store(n, std::memory_order_relaxed);
+    header_->epoch.fetch_add(1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+
+  size_type position(char const* p) const noexcept {
+    return p ? static_cast<size_type>(p - data_) : npos;
+  }
   
   
   static std::uint64_t nearest_power_of_2(std::uint64_t n) noexcept {
@@ -499,13 +713,62 @@ private:
     SYSTEM_INFO si;
     GetSystemInfo(&si);
     return si.dwPageSize;    
+#else
+    return static_cast<size_type>(sysconf(_SC_PAGESIZE));
 #endif 
   }
   
   
+  static constexpr size_type huge_page_size = 2097152;
+
+
+  // Huge pages are committed in whole huge pages
+  static size_type get_commit_size() noexcept {
+    auto const page_size = get_page_size();
+    if constexpr(PAGES == page_policy::standard)
+      return page_size;
+    else
+      return page_size > huge_page_size ? page_size : huge_page_size;
+  }
+
+
+  // No huge page policies on Windows, large pages there can't be committed
+  // on demand
   static char* reserve_pages(size_type capacity) noexcept {
 #if defined(_WIN32)
     return static_cast<char*>(VirtualAlloc(nullptr, capacity, MEM_RESERVE, PAGE_NOACCESS));
+#else
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+#if defined(MAP_HUGETLB)
+    if constexpr(PAGES == page_policy::explicit_huge) {
+      // without MAP_NORESERVE pool is checked now instead of SIGBUS on fault
+      void* reserved = mmap(nullptr, capacity, PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if(reserved != MAP_FAILED)
+        return static_cast<char*>(reserved);
+    }
+#endif
+
+    if constexpr(PAGES == page_policy::standard) {
+      void* reserved = mmap(nullptr, capacity, PROT_NONE, flags, -1, 0);
+      if(reserved == MAP_FAILED)
+        return nullptr;
+      return static_cast<char*>(reserved);
+    } else {
+      void* reserved = mmap(nullptr, capacity + huge_page_size, PROT_NONE, flags, -1, 0);
+      if(reserved == MAP_FAILED)
+        return nullptr;
+      auto const address = reinterpret_cast<std::uintptr_t>(reserved);
+      auto const aligned = (address + huge_page_size - 1) & ~std::uintptr_t(huge_page_size - 1);
+      if(aligned != address)
+        munmap(reserved, aligned - address);
+      munmap(reinterpret_cast<char*>(aligned + capacity), huge_page_size - (aligned - address));
+#if defined(MADV_HUGEPAGE)
+      madvise(reinterpret_cast<char*>(aligned), capacity, MADV_HUGEPAGE);
+#endif
+      return reinterpret_cast<char*>(aligned);
+    }
 #endif
   }
   
@@ -513,21 +776,85 @@ private:
   static char* commit_pages(char* address, size_type size) noexcept {
 #if defined(_WIN32)
   return static_cast<char*>(VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE));
+#else
+    if(mprotect(address, size, PROT_READ | PROT_WRITE) != 0)
+      return nullptr;
+    return address;
 #endif    
   }
   
   
+  static bool decommit_pages(char* address, size_type size) noexcept {
+#if defined(_WIN32)
+    return VirtualFree(address, size, MEM_DECOMMIT) != 0;
+#else
+    if(madvise(address, size, MADV_DONTNEED) != 0)
+      return false;
+    return mprotect(address, size, PROT_NONE) == 0;
+#endif
+  }
+
+
   static void release_pages(char* address, size_type size) noexcept {
 #if defined(_WIN32)
-    VirtualFree(address, size, MEM_RELEASE);
+    VirtualFree(address, 0, MEM_RELEASE);
+#else
+    munmap(address, size);
 #endif    
   }
   
   
+  // File offsets are offsets in region shifted by header
+  char* commit_range(char* base, size_type from, size_type to) noexcept {
+#if !defined(_WIN32)
+    if(descriptor_ != -1) {
+      if(ftruncate(descriptor_, off_t(offset_ + to)) != 0)
+        return nullptr;
+      void* mapped = mmap(base + from, to - from, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_FIXED, descriptor_, off_t(offset_ + from));
+      if(mapped == MAP_FAILED)
+        return nullptr;
+      return base + from;
+    }
+#endif
+    return commit_pages(base + from, to - from);
+  }
+
+
+  // Shared memory is kept, readers may still read below published size
+  bool decommit_range(char* base, size_type from, size_type to) noexcept {
+#if !defined(_WIN32)
+    if(header_ != nullptr)
+      return false;
+    if(descriptor_ != -1) {
+      void* reserved = mmap(base + from, to - from, PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+      if(reserved == MAP_FAILED)
+        return false;
+      return ftruncate(descriptor_, off_t(from)) == 0;
+    }
+#endif
+    return decommit_pages(base + from, to - from);
+  }
+
+
   void dispose() noexcept {
-    if(data_ == nullptr)
-      return;
-    release_pages(data_, reserved_capacity_);
+    if(data_ != nullptr)
+      release_pages(data_, reserved_capacity_);
+#if !defined(_WIN32)
+    if(header_ != nullptr) {
+      shm_unlink(header_->name);
+      munmap(header_, offset_);
+      header_ = nullptr;
+      offset_ = 0;
+    } else if(descriptor_ != -1) {
+      [[maybe_unused]] auto const truncated = ftruncate(descriptor_, off_t(size_));
+    }
+    if(descriptor_ != -1) {
+      close(descriptor_);
+      descriptor_ = -1;
+    }
+#endif
     data_ = nullptr;
     reserved_capacity_ = 0;
     committed_capacity_ = 0;
@@ -540,21 +867,62 @@ private:
     auto pages_count = MCAP / page_size;
     if(MCAP % page_size != 0 || pages_count == 0)
       ++pages_count;
-    auto const reserved_capacity = nearest_power_of_2(pages_count * page_size);     
+    auto reserved_capacity = nearest_power_of_2(pages_count * page_size);
+    // First commit is whole huge page, region is never smaller
+    if(reserved_capacity < get_commit_size())
+      reserved_capacity = get_commit_size();
     auto const reserved = reserve_pages(reserved_capacity);
     if(reserved == nullptr)
       return false;
-    auto const committed = commit_pages(reserved, page_size);
-    if(committed == nullptr)
+    auto const commit_size = get_commit_size();
+    auto const committed = commit_range(reserved, 0, commit_size);
+    if(committed == nullptr) {
+      release_pages(reserved, reserved_capacity);
       return false;
+    }
     reserved_capacity_ = reserved_capacity;
-    committed_capacity_ = page_size;
+    committed_capacity_ = commit_size;
     data_ = committed;
+    prefault();
     data_[0] = '\0';
     return true;
   }
+
+
+  void prefault() noexcept {
+    if constexpr(PREFAULT != 0) {
+      size_type const n = PREFAULT < reserved_capacity_ ? PREFAULT : reserved_capacity_;
+      if(!commit(n))
+        return;
+#if defined(MADV_POPULATE_WRITE)
+      if(madvise(data_, n, MADV_POPULATE_WRITE) == 0)
+        return;
+#endif
+      size_type const page_size = get_page_size();
+      for(size_type i = 0; i < n; i += page_size)
+        data_[i] = '\0';
+    }
+  }
   
   
+  // Never below first commit and prefaulted region
+  void decommit(size_type new_capacity) noexcept {
+    if(data_ == nullptr)
+      return;
+    auto const commit_size = get_commit_size();
+    if(new_capacity < commit_size)
+      new_capacity = commit_size;
+    if constexpr(PREFAULT != 0)
+      if(new_capacity < PREFAULT)
+        new_capacity = nearest_power_of_2(PREFAULT);
+    if(new_capacity >= committed_capacity_)
+      return;
+    if(!decommit_range(data_, new_capacity, committed_capacity_))
+      return;
+    committed_capacity_ = new_capacity;
+  }
+
+
   bool commit(size_type new_capacity) noexcept {
     
     if(new_capacity <= committed_capacity_)
@@ -567,7 +935,7 @@ private:
     if(new_capacity > reserved_capacity_)
       return false;
     
-    auto committed = commit_pages(&data_[size_], new_capacity - committed_capacity_);
+    auto committed = commit_range(data_, committed_capacity_, new_capacity);
     if(committed == nullptr)
       return false;
     
@@ -578,233 +946,355 @@ private:
 };
 
 
-template<std::size_t N>
-std::string& operator += (std::string const& x, continuous_string<N> const& y) {
+#if !defined(_WIN32)
+
+// Reader side of continuous_string placed to shared memory, may live in
+// other process
+class shared_view {
+public:
+
+  using size_type = std::uint64_t;
+
+
+  shared_view() noexcept = default;
+  shared_view(shared_view const&) = delete;
+  shared_view& operator = (shared_view const&) = delete;
+
+
+  explicit shared_view(char const* name) noexcept {
+    int const descriptor = shm_open(name, O_RDONLY, 0);
+    if(descriptor == -1)
+      return;
+    auto const page_size = size_type(sysconf(_SC_PAGESIZE));
+    void* header = mmap(nullptr, page_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    if(header != MAP_FAILED) {
+      auto const* shared = static_cast<detail::shared_header const*>(header);
+      auto const capacity = shared->capacity.load(std::memory_order_acquire);
+      void* data = MAP_FAILED;
+      if(capacity != 0)
+        data = mmap(nullptr, capacity, PROT_READ, MAP_SHARED, descriptor, off_t(page_size));
+      if(data != MAP_FAILED) {
+        header_ = shared;
+        header_size_ = page_size;
+        data_ = static_cast<char const*>(data);
+        capacity_ = capacity;
+      } else {
+        munmap(header, page_size);
+      }
+    }
+    close(descriptor);
+  }
+
+
+  shared_view(shared_view&& other) noexcept:
+    header_{other.header_}, header_size_{other.header_size_},
+    data_{other.data_}, capacity_{other.capacity_} {
+    other.header_ = nullptr;
+    other.data_ = nullptr;
+  }
+
+
+  shared_view& operator = (shared_view&& other) noexcept {
+    dispose();
+    header_ = other.header_; other.header_ = nullptr;
+    header_size_ = other.header_size_;
+    data_ = other.data_; other.data_ = nullptr;
+    capacity_ = other.capacity_;
+    return *this;
+  }
+
+
+  ~shared_view() { dispose(); }
+
+
+  explicit operator bool () const noexcept { return header_ != nullptr; }
+
+
+  // Published content in place, writer may overwrite it once it clears;
+  // take epoch() before and check unchanged() after reading it
+  std::string_view view() const noexcept {
+    if(header_ == nullptr)
+      return {};
+    return {data_, header_->size.load(std::memory_order_acquire)};
+  }
+
+
+  // Changes when writer clears or shortens published content
+  size_type epoch() const noexcept {
+    if(header_ == nullptr)
+      return 0;
+    return header_->epoch.load(std::memory_order_acquire);
+  }
+
+
+  // True if nothing read since epoch() was taken has been overwritten
+  bool unchanged(size_type epoch) const noexcept {
+    if(header_ == nullptr)
+      return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header_->epoch.load(std::memory_order_relaxed) == epoch;
+  }
+
+
+  // Copies published content, false if writer overwrote it meanwhile
+  // and target is to be discarded
+  bool read(std::string& target) const {
+    auto const before = epoch();
+    auto const content = view();
+    target.assign(content.data(), content.size());
+    return unchanged(before);
+  }
+
+
+private:
+
+  detail::shared_header const* header_{nullptr};
+  size_type header_size_{0};
+  char const* data_{nullptr};
+  size_type capacity_{0};
+
+
+  void dispose() noexcept {
+    if(header_ == nullptr)
+      return;
+    munmap(const_cast<char*>(data_), capacity_);
+    munmap(const_cast<detail::shared_header*>(header_), header_size_);
+    header_ = nullptr;
+    data_ = nullptr;
+  }
+
+}; // shared_view
+
+#endif
+
+
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+std::string& operator += (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return x.append(y.data(), y.size());
 }
 
 
-template<std::size_t N>
-bool operator == (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) == 0;
 }
 
 
-template<std::size_t N>
-bool operator == (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator == (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) == 0;
 }
 
 
-template<std::size_t N>
-bool operator != (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) != 0;
 }
 
 
-template<std::size_t N>
-bool operator != (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator != (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator != (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator != (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator != (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator != (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator != (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator < (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator < (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator < (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator < (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator < (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator < (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator < (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator < (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator <= (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator <= (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator > (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator > (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator > (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator > (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator > (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator > (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator > (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator > (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (continuous_string<N> const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (continuous_string<N, P, F, A> const& x, continuous_string<N, P, F, A> const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (continuous_string<N> const& x, char const* y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (continuous_string<N, P, F, A> const& x, char const* y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (char const* x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (char const* x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (continuous_string<N> const& x, std::string const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (continuous_string<N, P, F, A> const& x, std::string const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (std::string const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (std::string const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (continuous_string<N> const& x, std::string_view const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (continuous_string<N, P, F, A> const& x, std::string_view const& y) {
   return x.compare(y) != 0;
 }
 
-template<std::size_t N>
-bool operator >= (std::string_view const& x, continuous_string<N> const& y) {
+template<std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+bool operator >= (std::string_view const& x, continuous_string<N, P, F, A> const& y) {
   return y.compare(x) != 0;
 }
 
 
-template<typename OS, std::size_t N>
-OS& operator << (OS& stream, continuous_string<N> const& fs) {
+template<typename OS, std::uint64_t N, page_policy P, std::uint64_t F, unsigned A>
+OS& operator << (OS& stream, continuous_string<N, P, F, A> const& fs) {
   stream << std::string_view{ fs.data(), fs.size() };
   return stream;
 }
@@ -0,0 +1,511 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "texter.hpp"
+#include "output.hpp"
+
+
+namespace uformat {
+
+
+  namespace detail::deferred {
+
+
+    template<typename T> struct is_fixed_string: std::false_type { };
+    template<size_t N> struct is_fixed_string<fixed_string<N>>: std::true_type { };
+
+
+    template<typename Arg>
+    constexpr bool is_number = std::is_arithmetic_v<argument_type<Arg>>;
+
+    template<typename Arg>
+    constexpr bool is_text = std::is_same_v<std::decay_t<Arg>, char const*>
+      || std::is_same_v<std::decay_t<Arg>, char*>
+      || std::is_same_v<argument_type<Arg>, std::string>
+      || std::is_same_v<argument_type<Arg>, std::string_view>
+      || is_fixed_string<argument_type<Arg>>::value;
+
+    // Anything else is formatted on the calling thread and stored as text
+    template<typename Arg>
+    constexpr bool is_formatted = !is_number<Arg> && !is_text<Arg>;
+
+    template<typename Arg>
+    using stored_type = std::conditional_t<is_number<Arg>, argument_type<Arg>, std::string_view>;
+
+
+    // Constant character arrays are taken as literals like texter::print does
+    template<typename Arg>
+    std::string_view text(Arg const& arg) noexcept {
+      using type = std::remove_reference_t<Arg>;
+      if constexpr(std::is_array_v<type> && std::is_const_v<type>)
+        return {arg, std::extent_v<type> - 1};
+      else if constexpr(std::is_array_v<type>)
+        return std::string_view{arg};
+      else if constexpr(std::is_pointer_v<type>)
+        return arg ? std::string_view{arg} : std::string_view{};
+      else
+        return {arg.data(), arg.size()};
+    }
+
+
+    using decoder = void (*)(char const*, dynamic_texter&);
+
+    struct header {
+      decoder decode;
+      uint32_t size;
+      int32_t descriptor;
+    };
+
+
+    template<typename T> T read(char const*& p) noexcept {
+      if constexpr(std::is_arithmetic_v<T>) {
+        T x;
+        std::memcpy(&x, p, sizeof(x));
+        p += sizeof(x);
+        return x;
+      } else {
+        uint32_t n;
+        std::memcpy(&n, p, sizeof(n));
+        p += sizeof(n);
+        T const text{p, n};
+        p += n;
+        return text;
+      }
+    }
+
+
+    template<typename... Stored>
+    void decode(char const* p, dynamic_texter& out) {
+      // braced initialization reads arguments left to right
+      std::tuple<Stored...> const values{read<Stored>(p)...};
+      std::apply([&out](auto const&... value) { out.print(value..., '\n'); }, values);
+    }
+
+
+    // Byte ring with one producer thread and the logger's writer thread as
+    // consumer. Record that does not fit before the end of the ring starts
+    // from the beginning, the rest of the ring is skipped
+    class queue {
+    public:
+
+      explicit queue(size_t capacity):
+        data_{new char[capacity]}, capacity_{capacity}
+      { }
+
+
+      size_t capacity() const noexcept { return capacity_; }
+
+
+      char* allocate(size_t n) noexcept {
+        size_t const head = head_.load(std::memory_order_relaxed);
+        size_t const contiguous = capacity_ - (head & (capacity_ - 1));
+        size_t const skip = contiguous < n ? contiguous : 0;
+        if(head + skip + n - cached_tail_ > capacity_) {
+          cached_tail_ = tail_.load(std::memory_order_acquire);
+          if(head + skip + n - cached_tail_ > capacity_)
+            return nullptr;
+        }
+        if(skip >= sizeof(header)) {
+          header const wrap{nullptr, 0, 0};
+          std::memcpy(&data_[head & (capacity_ - 1)], &wrap, sizeof(wrap));
+        }
+        allocated_ = head + skip + n;
+        return &data_[(head + skip) & (capacity_ - 1)];
+      }
+
+
+      void commit() noexcept {
+        head_.store(allocated_, std::memory_order_release);
+      }
+
+
+      // Decodes available records, calls f(descriptor) before each one
+      template<typename F> bool consume(dynamic_texter& out, F&& f) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t const head = head_.load(std::memory_order_acquire);
+        if(tail == head)
+          return false;
+        while(tail != head) {
+          size_t const offset = tail & (capacity_ - 1);
+          size_t const contiguous = capacity_ - offset;
+          header h{nullptr, 0, 0};
+          if(contiguous >= sizeof(header))
+            std::memcpy(&h, &data_[offset], sizeof(h));
+          if(h.decode == nullptr) {
+            tail += contiguous;
+            continue;
+          }
+          f(h.descriptor);
+          h.decode(&data_[offset + sizeof(header)], out);
+          tail += sizeof(header) + h.size;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return true;
+      }
+
+
+      bool empty() const noexcept {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+      }
+
+
+      void abandon() noexcept { abandoned_.store(true, std::memory_order_release); }
+      bool abandoned() const noexcept { return abandoned_.load(std::memory_order_acquire); }
+      void retire() noexcept { retired_.store(true, std::memory_order_release); }
+      bool retired() const noexcept { return retired_.load(std::memory_order_acquire); }
+
+    private:
+
+      std::unique_ptr<char[]> data_;
+      size_t const capacity_;
+      alignas(64) std::atomic<size_t> head_{0};
+      size_t cached_tail_{0};
+      size_t allocated_{0};
+      alignas(64) std::atomic<size_t> tail_{0};
+      std::atomic<bool> abandoned_{false};
+      std::atomic<bool> retired_{false};
+    }; // queue
+
+
+    // Producer thread's handle, marks queue abandoned on thread exit
+    struct registration {
+      uint64_t logger;
+      std::shared_ptr<queue> target;
+
+      registration(uint64_t logger, std::shared_ptr<queue> target) noexcept:
+        logger{logger}, target{std::move(target)}
+      { }
+
+      registration(registration&&) noexcept = default;
+      registration& operator = (registration&&) noexcept = default;
+
+      ~registration() {
+        if(target)
+          target->abandon();
+      }
+    };
+
+
+    inline std::atomic<uint64_t> logger_counter{0};
+
+
+  } // detail::deferred
+
+
+  // NanoLog-style logger: print() only copies arguments into calling
+  // thread's queue behind decoder for their types, writer thread formats
+  // them with texter::print and writes lines in large batches
+  class deferred_logger {
+  public:
+
+    using size_type = size_t;
+
+    static constexpr size_type default_queue_capacity = 1 << 20;
+    static constexpr size_type batch_size = 65536;
+    static constexpr auto poll_interval = std::chrono::microseconds{100};
+
+
+    explicit deferred_logger(overflow policy = overflow::block,
+                             size_type queue_capacity = default_queue_capacity,
+                             std::FILE* out = stdout, std::FILE* err = stderr):
+      policy_{policy},
+      queue_capacity_{round_capacity(queue_capacity)},
+      out_{detail::output::descriptor(out)},
+      err_{detail::output::descriptor(err)} {
+      writer_ = std::thread{[this]{ drain(); }};
+    }
+
+
+    deferred_logger(deferred_logger const&) = delete;
+    deferred_logger& operator = (deferred_logger const&) = delete;
+
+
+    ~deferred_logger() {
+      stopping_.store(true, std::memory_order_release);
+      writer_.join();
+      for(auto& each: queues_)
+        each->retire();
+    }
+
+
+    overflow policy() const noexcept { return policy_; }
+    size_type queue_capacity() const noexcept { return queue_capacity_; }
+
+
+    // Lines dropped with overflow::drop_and_count
+    uint64_t dropped() const noexcept {
+      return dropped_.load(std::memory_order_relaxed);
+    }
+
+
+    // Returns false when line was dropped, lines longer than half of
+    // queue capacity are always dropped
+    template<typename... Args>
+    bool print(Args&&... args) {
+      return push(out_, std::forward<Args>(args)...);
+    }
+
+
+    template<typename R, typename... Args>
+    R print_with(R&& result, Args&&... args) {
+      print(std::forward<Args>(args)...);
+      return std::move(std::forward<R>(result));
+    }
+
+
+    template<typename... Args>
+    bool error(Args&&... args) {
+      return push(err_, std::forward<Args>(args)...);
+    }
+
+
+    template<typename R, typename... Args>
+    R error_with(R&& result, Args&&... args) {
+      error(std::forward<Args>(args)...);
+      return std::move(std::forward<R>(result));
+    }
+
+
+  private:
+
+    using queue = detail::deferred::queue;
+    using header = detail::deferred::header;
+
+    overflow const policy_;
+    size_type const queue_capacity_;
+    int const out_;
+    int const err_;
+    uint64_t const id_{++detail::deferred::logger_counter};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex sync_;
+    std::vector<std::shared_ptr<queue>> queues_;
+    std::atomic<size_type> registered_{0};
+    std::thread writer_;
+
+
+    static size_type round_capacity(size_type n) {
+      size_type capacity = 4096;
+      while(capacity < n)
+        capacity <<= 1;
+      return capacity;
+    }
+
+
+    queue& local_queue() {
+      thread_local uint64_t last_logger = 0;
+      thread_local queue* last_queue = nullptr;
+      if(last_logger == id_)
+        return *last_queue;
+      thread_local std::vector<detail::deferred::registration> registrations;
+      for(auto& each: registrations)
+        if(each.logger == id_) {
+          last_logger = id_;
+          last_queue = each.target.get();
+          return *last_queue;
+        }
+      auto const retired = [](detail::deferred::registration const& r) {
+        return r.target->retired();
+      };
+      registrations.erase(std::remove_if(registrations.begin(), registrations.end(), retired),
+                          registrations.end());
+      auto created = std::make_shared<queue>(queue_capacity_);
+      {
+        std::unique_lock g{sync_};
+        queues_.push_back(created);
+      }
+      registered_.fetch_add(1, std::memory_order_release);
+      registrations.emplace_back(id_, created);
+      last_logger = id_;
+      last_queue = created.get();
+      return *created;
+    }
+
+
+    template<typename... Args>
+    bool push(int descriptor, Args&&... args) {
+      using namespace detail::deferred;
+
+      constexpr size_type formatted_count = (size_type(is_formatted<Args>) + ... + 0);
+      uint32_t lengths[formatted_count != 0 ? formatted_count : 1]{};
+      dynamic_texter* formatted = nullptr;
+      if constexpr(formatted_count != 0) {
+        thread_local dynamic_texter scratch;
+        scratch.clear();
+        size_type i = 0;
+        (format_argument<Args>(scratch, lengths, i, args), ...);
+        formatted = &scratch;
+      }
+
+      size_type i = 0;
+      size_type n = sizeof(header);
+      ((n += encoded_size<Args>(lengths, i, args)), ...);
+      // Longer record may never fit after the skipped end of the ring
+      if(n > queue_capacity_ / 2)
+        return drop();
+
+      queue& q = local_queue();
+      char* p = q.allocate(n);
+      while(p == nullptr) {
+        if(policy_ != overflow::block)
+          return drop();
+        std::this_thread::yield();
+        p = q.allocate(n);
+      }
+
+      header const h{&decode<stored_type<Args>...>, uint32_t(n - sizeof(header)), descriptor};
+      std::memcpy(p, &h, sizeof(h));
+      p += sizeof(h);
+      char const* cursor = formatted ? formatted->data() : nullptr;
+      i = 0;
+      (encode<Args>(p, cursor, lengths, i, args), ...);
+      q.commit();
+      return true;
+    }
+
+
+    bool drop() noexcept {
+      if(policy_ == overflow::drop_and_count)
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+
+    template<typename Arg>
+    static void format_argument(dynamic_texter& scratch, uint32_t* lengths,
+                                size_type& i, Arg const& arg) {
+      if constexpr(detail::deferred::is_formatted<Arg>) {
+        size_type const previous_size = scratch.size();
+        scratch << arg;
+        lengths[i++] = uint32_t(scratch.size() - previous_size);
+      }
+    }
+
+
+    template<typename Arg>
+    static size_type encoded_size(uint32_t const* lengths, size_type& i, Arg const& arg) {
+      using namespace detail::deferred;
+      if constexpr(is_number<Arg>)
+        return sizeof(detail::argument_type<Arg>);
+      else if constexpr(is_text<Arg>)
+        return sizeof(uint32_t) + text<Arg>(arg).size();
+      else
+        return sizeof(uint32_t) + lengths[i++];
+    }
+
+
+    template<typename Arg>
+    static void encode(char*& p, char const*& formatted, uint32_t const* lengths,
+                       size_type& i, Arg const& arg) {
+      using namespace detail::deferred;
+      if constexpr(is_number<Arg>) {
+        detail::argument_type<Arg> const x = arg;
+        std::memcpy(p, &x, sizeof(x));
+        p += sizeof(x);
+      } else {
+        std::string_view value;
+        if constexpr(is_text<Arg>) {
+          value = text<Arg>(arg);
+        } else {
+          value = std::string_view{formatted, lengths[i++]};
+          formatted += value.size();
+        }
+        uint32_t const n = uint32_t(value.size());
+        std::memcpy(p, &n, sizeof(n));
+        p += sizeof(n);
+        if(n != 0)
+          std::memcpy(p, value.data(), n);
+        p += n;
+      }
+    }
+
+
+    void drain() {
+      dynamic_texter batch;
+      batch.reserve(batch_size);
+      int batch_descriptor = out_;
+      std::vector<std::shared_ptr<queue>> active;
+      auto const before_record = [&](int descriptor) {
+        if(descriptor != batch_descriptor || batch.size() >= batch_size) {
+          flush(batch_descriptor, batch);
+          batch_descriptor = descriptor;
+        }
+      };
+
+      size_type registered = 0;
+      bool idle = true;
+
+      for(;;) {
+        bool const stopping = stopping_.load(std::memory_order_acquire);
+        if(idle || registered != registered_.load(std::memory_order_acquire)) {
+          std::unique_lock g{sync_};
+          registered = registered_.load(std::memory_order_acquire);
+          auto const finished = [](std::shared_ptr<queue> const& q) {
+            return q->abandoned() && q->empty();
+          };
+          queues_.erase(std::remove_if(queues_.begin(), queues_.end(), finished),
+                        queues_.end());
+          active = queues_;
+        }
+
+        bool consumed = false;
+        for(auto& q: active)
+          consumed |= q->consume(batch, before_record);
+        idle = !consumed;
+        if(consumed)
+          continue;
+
+        flush(batch_descriptor, batch);
+        if(stopping)
+          return;
+        std::this_thread::sleep_for(poll_interval);
+      }
+    }
+
+
+    static void flush(int descriptor, dynamic_texter& batch) {
+      if(batch.empty())
+        return;
+      detail::output::write(descriptor, batch.data(), batch.size());
+      batch.clear();
+    }
+  }; // deferred_logger
+
+
+} // uformat
@@ -23,19 +23,48 @@
 #pragma once
 
 
+#if __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#error uformat requires C++20
+#endif
+
+
+#include <compare>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <string>
 #include <string_view>
 #include <iosfwd>
 #include <stdexcept>
+#include <type_traits>
+#include "hash.hpp"
+#include "search.hpp"
 #include "utf8.hpp"
 
 
 namespace uformat {
 
 
+  namespace detail {
+
+    // Smallest unsigned type to keep length up to N
+    template<std::size_t N>
+    using fixed_length_t =
+      std::conditional_t<N <= 0xFF, std::uint8_t,
+      std::conditional_t<N <= 0xFFFF, std::uint16_t,
+      std::conditional_t<N <= 0xFFFFFFFF, std::uint32_t, std::uint64_t>>>;
+
+    // Strings filling whole cache lines are aligned to cache line
+    template<std::size_t N>
+    constexpr std::size_t fixed_alignment =
+      (sizeof(fixed_length_t<N>) + N + 1) % 64 == 0 ? 64 : alignof(fixed_length_t<N>);
+
+  } // detail
+
+
   template<std::size_t N>
-  class fixed_string {
+  class alignas(detail::fixed_alignment<N>) fixed_string {
   public:
 
     using value_type = char;
@@ -50,22 +79,29 @@ namespace uformat {
 
     static constexpr size_type npos = size_type(-1);
 
-    fixed_string() noexcept: n_(0) {
-      p_[0] = '\0';
+    constexpr fixed_string() noexcept {
+      initialize();
     }
 
-    fixed_string(fixed_string const& rhs) noexcept {
-      assign(rhs.begin(), rhs.end());
+    constexpr fixed_string(fixed_string const& rhs) noexcept {
+      initialize();
+      append(rhs.begin(), rhs.end());
     }
 
     template<std::size_t M>
-    fixed_string(fixed_string<M> const& rhs) noexcept {
-      assign(rhs.begin(), rhs.end());
+    constexpr fixed_string(fixed_string<M> const& rhs) noexcept {
+      initialize();
+      append(rhs.begin(), rhs.end());
     }
     
+    // Implicit for arrays that fit, so string literals are taken as
+    // template arguments; longer arrays are truncated and need explicit
+    // construction
     template<std::size_t M>
-    explicit fixed_string(char const (&data)[M]) noexcept {
-      assign(data, data + M);
+    constexpr explicit(M > N + 1) fixed_string(char const (&data)[M]) noexcept {
+      initialize();
+      char const* const z = std::char_traits<char>::find(data, M, '\0');
+      append(data, z ? z : data + M);
     }
     
     template<std::size_t M>
@@ -73,133 +109,139 @@ namespace uformat {
       assign(data, data + M);
     }
 
-    explicit fixed_string(char const* data) noexcept {
-      assign(data);
+    explicit constexpr fixed_string(char const* data) noexcept {
+      initialize();
+      append(data);
     }
 
     explicit fixed_string(wchar_t const* data) noexcept {
       assign(data);
     }
 
-    fixed_string(char const* b, char const* e) noexcept {
-      assign(b, e);
+    constexpr fixed_string(char const* b, char const* e) noexcept {
+      initialize();
+      append(b, e);
     }
 
     fixed_string(wchar_t const* b, wchar_t const* e) noexcept {
       assign(b, e);
     }
 
-    explicit fixed_string(std::string const& rhs) noexcept {
-      assign(rhs.data(), rhs.data() + rhs.size());
+    explicit constexpr fixed_string(std::string const& rhs) noexcept {
+      initialize();
+      append(rhs.data(), rhs.data() + rhs.size());
     }
 
-    explicit fixed_string(std::string_view const& rhs) noexcept {
-      assign(rhs.data(), rhs.data() + rhs.size());
+    explicit constexpr fixed_string(std::string_view const& rhs) noexcept {
+      initialize();
+      append(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& operator = (fixed_string const& rhs) noexcept {
+    constexpr fixed_string& operator = (fixed_string const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
     template<std::size_t M>
-    fixed_string& operator = (fixed_string<M> const& rhs) noexcept {
+    constexpr fixed_string& operator = (fixed_string<M> const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& operator = (char const* data) noexcept {
+    constexpr fixed_string& operator = (char const* data) noexcept {
       return assign(data);
     }
 
-    fixed_string& operator = (std::string const& rhs) noexcept {
+    constexpr fixed_string& operator = (std::string const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& operator = (std::string_view const& rhs) noexcept {
+    constexpr fixed_string& operator = (std::string_view const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    char* begin() noexcept { return p_; }
-    char* end() noexcept { return p_ + n_; }
-    char const* begin() const noexcept { return p_; }
-    char const* end() const noexcept { return p_ + n_; }
-    char const* cbegin() const noexcept { return p_; }
-    char const* cend() const noexcept { return p_ + n_; }
+    constexpr char* begin() noexcept { return p_; }
+    constexpr char* end() noexcept { return p_ + n_; }
+    constexpr char const* begin() const noexcept { return p_; }
+    constexpr char const* end() const noexcept { return p_ + n_; }
+    constexpr char const* cbegin() const noexcept { return p_; }
+    constexpr char const* cend() const noexcept { return p_ + n_; }
 
-    size_type size() const noexcept { return n_; }
-    size_type length() const noexcept { return n_; }
-    size_type max_size() const noexcept { return N; }
+    constexpr size_type size() const noexcept { return n_; }
+    constexpr size_type length() const noexcept { return n_; }
+    constexpr size_type max_size() const noexcept { return N; }
     constexpr size_type capacity() const noexcept { return N; }
-    bool empty() const noexcept { return n_ == 0; }
-    void clear() noexcept { n_ = 0; p_[0] = '\0'; }
-    void reserve(size_type) noexcept { }
+    constexpr bool empty() const noexcept { return n_ == 0; }
+    constexpr void clear() noexcept { truncate(0); }
+    constexpr void reserve(size_type) noexcept { }
 
-    void resize(size_type n) noexcept {
+    constexpr void resize(size_type n) noexcept {
       if(n > N)
         return;
-      n_ = n; p_[n] = '\0';
+      if(n < n_)
+        return truncate(n);
+      n_ = static_cast<length_type>(n); p_[n] = '\0';
     }
 
-    char& operator [] (size_type i) noexcept {
+    constexpr char& operator [] (size_type i) noexcept {
       return p_[i];
     }
 
-    char const& operator [] (size_type i) const noexcept {
+    constexpr char const& operator [] (size_type i) const noexcept {
       return p_[i];
     }
 
-    char& at (size_type i) {
+    constexpr char& at (size_type i) {
       if(i >= n_)
         throw std::out_of_range("invalid string position");
       return p_[i];
     }
 
-    char const& at (size_type i) const {
+    constexpr char const& at (size_type i) const {
       if(i >= n_)
         throw std::out_of_range("invalid string position");
       return p_[i];
     }
 
-    char& back() noexcept { return p_[n_ - 1]; }
-    char const& back() const noexcept { return p_[n_ - 1]; }
-    char& front() noexcept { return p_[0]; }
-    char const& front() const noexcept { return p_[0]; }
+    constexpr char& back() noexcept { return p_[n_ - 1]; }
+    constexpr char const& back() const noexcept { return p_[n_ - 1]; }
+    constexpr char& front() noexcept { return p_[0]; }
+    constexpr char const& front() const noexcept { return p_[0]; }
 
-    fixed_string& operator += (char c) noexcept {
+    constexpr fixed_string& operator += (char c) noexcept {
       push_back(c);
       return *this;
     }
 
     template<std::size_t M>
-    fixed_string& operator += (fixed_string<M> const& rhs) noexcept {
+    constexpr fixed_string& operator += (fixed_string<M> const& rhs) noexcept {
       return append(rhs.begin(), rhs.end());
     }
 
-    fixed_string& operator += (char const* cc) noexcept {
+    constexpr fixed_string& operator += (char const* cc) noexcept {
       return append(cc);
     }
 
-    fixed_string& operator += (std::string const& rhs) noexcept {
+    constexpr fixed_string& operator += (std::string const& rhs) noexcept {
       return append(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& operator += (std::string_view const& rhs) noexcept {
+    constexpr fixed_string& operator += (std::string_view const& rhs) noexcept {
       return append(rhs.data(), rhs.data() + rhs.size());
     }
 
     template<std::size_t M>
-    fixed_string& append(fixed_string<M> const& rhs) noexcept {
+    constexpr fixed_string& append(fixed_string<M> const& rhs) noexcept {
       return append(rhs.begin(), rhs.end());
     }
 
-    fixed_string& append(std::string const& rhs) noexcept {
+    constexpr fixed_string& append(std::string const& rhs) noexcept {
       return append(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& append(std::string_view const& rhs) noexcept {
+    constexpr fixed_string& append(std::string_view const& rhs) noexcept {
       return append(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& append(char const* cc, size_type n) noexcept {
+    constexpr fixed_string& append(char const* cc, size_type n) noexcept {
       return append(cc, cc + n);
     }
 
@@ -207,15 +249,15 @@ namespace uformat {
       return append(cc, cc + n);
     }
 
-    fixed_string& append(char const* cc) noexcept {
+    constexpr fixed_string& append(char const* cc) noexcept {
       if(n_ == N || !cc)
         return *this;
-      char* c = p_ + n_;
-      while(n_ != N && *cc != '\0') {
-        *c++ = *cc++;
-        ++n_;
-      }
-      *c = '\0';
+      size_type const l = N - n_;
+      char const* const z = std::char_traits<char>::find(cc, l, '\0');
+      size_type const n = z ? static_cast<size_type>(z - cc) : l;
+      std::char_traits<char>::move(p_ + n_, cc, n);
+      n_ = static_cast<length_type>(n_ + n);
+      p_[n_] = '\0';
       return *this;
     }
 
@@ -232,16 +274,15 @@ namespace uformat {
       return *this;
     }
 
-    fixed_string& append(char const* b, char const* e) noexcept {
+    constexpr fixed_string& append(char const* b, char const* e) noexcept {
       if(!b || !e || b == e)
         return *this;
       size_type const m = static_cast<size_type>(e - b);
       size_type const l = N - n_;
       size_type const n = m > l ? l : m;
-      e = b + n;
-      for(char* p = p_ + n_; b != e; ++p, ++b)
-        *p = *b;
-      n_ += n;
+      // source may be inside this string when assigning
+      std::char_traits<char>::move(p_ + n_, b, n);
+      n_ = static_cast<length_type>(n_ + n);
       p_[n_] = '\0';
       return *this;
     }
@@ -256,12 +297,12 @@ namespace uformat {
       for(char* p = p_ + n_; b != e; ++p, ++b)
         // TODO: utf-8 conversion
         *p = static_cast<char>(*b);
-      n_ += n;
+      n_ = static_cast<length_type>(n_ + n);
       p_[n_] = '\0';
       return *this;
     }
 
-    void push_back(char c) noexcept {
+    constexpr void push_back(char c) noexcept {
       if(n_ >= N) return;
       p_[n_++] = c;
       p_[n_] = '\0';
@@ -273,34 +314,37 @@ namespace uformat {
       if(!utf8::code_point_to_octets(&c, p, p_ + N + 1))
         return;
       *p = '\0';
-      n_ = p - p_;
+      n_ = static_cast<length_type>(p - p_);
     }
 
-    void pop_back() noexcept {
+    constexpr void pop_back() noexcept {
       if(n_ == 0) return;
       p_[--n_] = '\0';
     }
 
-    fixed_string& assign(fixed_string const& rhs) noexcept {
+    constexpr fixed_string& assign(fixed_string const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    template<int M>
-    fixed_string& assign(fixed_string<M> const& rhs) noexcept {
+    template<std::size_t M>
+    constexpr fixed_string& assign(fixed_string<M> const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& assign(std::string const& rhs) noexcept {
+    constexpr fixed_string& assign(std::string const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& assign(std::string_view const& rhs) noexcept {
+    constexpr fixed_string& assign(std::string_view const& rhs) noexcept {
       return assign(rhs.data(), rhs.data() + rhs.size());
     }
 
-    fixed_string& assign(char const* data) noexcept {
-      n_ = 0; p_[0] = '\0';
-      return append(data);
+    constexpr fixed_string& assign(char const* data) noexcept {
+      size_type const previous = n_;
+      n_ = 0;
+      append(data);
+      terminate(previous);
+      return *this;
     }
 
     fixed_string& assign(wchar_t const* data) noexcept {
@@ -308,9 +352,13 @@ namespace uformat {
       return append(data);
     }
 
-    fixed_string& assign(char const* b, char const* e) noexcept {
-      n_ = 0; p_[0] = '\0';
-      return append(b, e);
+    constexpr fixed_string& assign(char const* b, char const* e) noexcept {
+      // source may be inside this string
+      size_type const previous = n_;
+      n_ = 0;
+      append(b, e);
+      terminate(previous);
+      return *this;
     }
 
     fixed_string& assign(wchar_t const* b, wchar_t const* e) noexcept {
@@ -318,305 +366,328 @@ namespace uformat {
       return append(b, e);
     }
 
-    char const* c_str() const noexcept { return p_; }
-    char const* data() const noexcept { return p_; }
+    constexpr char const* c_str() const noexcept { return p_; }
+    constexpr char const* data() const noexcept { return p_; }
+
+    constexpr size_type find(char c, size_type i = 0) const noexcept {
+      if(std::is_constant_evaluated())
+        return view().find(c, i);
+      if(i >= n_)
+        return npos;
+      return position(detail::find_char(p_ + i, p_ + n_, c));
+    }
+
+    constexpr size_type find(std::string_view s, size_type i = 0) const noexcept {
+      if(std::is_constant_evaluated())
+        return view().find(s, i);
+      if(i > n_)
+        return npos;
+      if(s.empty())
+        return i;
+      return position(detail::find_substring(p_ + i, p_ + n_, s));
+    }
+
+    constexpr size_type rfind(char c, size_type i = npos) const noexcept {
+      if(std::is_constant_evaluated())
+        return view().rfind(c, i);
+      if(n_ == 0)
+        return npos;
+      size_type const e = i >= n_ ? n_ : i + 1;
+      return position(detail::rfind_char(p_, p_ + e, c));
+    }
+
+    constexpr size_type find_first_of(char c) const noexcept {
+      return find(c, 0);
+    }
 
-    size_type find_first_of(char c) const noexcept {
-      return find_first_of(c, 0);
+    constexpr size_type find_first_of(char c, size_type i) const noexcept {
+      return find(c, i);
     }
 
-    size_type find_first_of(char c, size_type i) const noexcept {
+    constexpr size_type find_first_of(std::string_view set, size_type i = 0) const noexcept {
+      if(std::is_constant_evaluated())
+        return view().find_first_of(set, i);
       if(i >= n_)
         return npos;
-      for(char const *p = p_ + i, *e = p_ + n_; p != e; ++p)
-        if(*p == c)
-          return static_cast<size_type>(p - p_);
-      return npos;
+      return position(detail::find_of(p_ + i, p_ + n_, set, true));
     }
 
-    size_type find_last_of(char c) const noexcept {
-      return find_last_of(c, n_ - 1);
+    constexpr size_type find_first_not_of(std::string_view set, size_type i = 0) const noexcept {
+      if(std::is_constant_evaluated())
+        return view().find_first_not_of(set, i);
+      if(i >= n_)
+        return npos;
+      return position(detail::find_of(p_ + i, p_ + n_, set, false));
     }
 
-    size_type find_last_of(char c, size_type i) const noexcept {
-      for(char const* p = p_ + i; p != p_ - 1; --p)
-        if(*p == c)
-          return static_cast<size_type>(p - p_);
-      return npos;
+    constexpr size_type find_last_of(char c) const noexcept {
+      return rfind(c, npos);
     }
 
-    std::string_view substr(size_type pos, size_type n) const noexcept {
+    constexpr size_type find_last_of(char c, size_type i) const noexcept {
+      return rfind(c, i);
+    }
+
+    constexpr std::string_view substr(size_type pos, size_type n) const noexcept {
       return std::string_view{p_ + pos, p_ + pos + n};
     }
 
-    template<int M>
-    int compare(fixed_string<M> const& rhs) const noexcept {
+    template<std::size_t M>
+    constexpr int compare(fixed_string<M> const& rhs) const noexcept {
       return compare(rhs.begin(), rhs.end());
     }
 
-    int compare(std::string const& rhs) const noexcept {
-      return compare(rhs.begin(), rhs.end());
+    constexpr int compare(std::string const& rhs) const noexcept {
+      return compare(rhs.data(), rhs.data() + rhs.size());
     }
 
-    int compare(std::string_view const& rhs) const noexcept {
-      return compare(rhs.begin(), rhs.end());
+    constexpr int compare(std::string_view const& rhs) const noexcept {
+      return compare(rhs.data(), rhs.data() + rhs.size());
     }
 
-    int compare(char const* b, char const* e) const noexcept {
-      if(b == e)
-        return n_ == 0 ? 0 : 1;
-      char const* c = p_;
-      while(*c == *b && b != e) {
-        ++c; ++b;
-      }
-      if(b == e) return 0;
-      else if(*c > *b) return 1;
-      else return -1;
+    constexpr int compare(char const* b, char const* e) const noexcept {
+      int const r = view().compare(std::string_view{b, static_cast<size_type>(e - b)});
+      return r < 0 ? -1 : r > 0 ? 1 : 0;
     }
 
-    int compare(char const* s) const noexcept {
+    constexpr int compare(char const* s) const noexcept {
       if(s == nullptr)
         return n_ == 0 ? 0 : 1;
-      char const* c = p_;
-      while(*c == *s && *c != '\0') {
-        ++c; ++s;
-      }
-      if(*c == *s) return 0;
-      else if(*c > *s) return 1;
-      else return -1;
+      return compare(s, s + std::char_traits<char>::length(s));
     }
 
-  private:
+    // Comparisons are length check and memcmp of string_view
+    constexpr std::string_view view() const noexcept {
+      return std::string_view{p_, n_};
+    }
+
+    // Data members are public only to make fixed_string a structural type,
+    // so it can be used as template argument
+    using length_type = detail::fixed_length_t<N>;
 
-    size_type n_;
+    length_type n_;
     char p_[N + 1];
 
-  }; //  fixed_string
+  private:
 
+    // Template arguments are equal when all of p_ is equal,
+    // so constant evaluation keeps unused characters zero
+    constexpr void initialize() noexcept {
+      if(std::is_constant_evaluated())
+        for(char& c: p_)
+          c = '\0';
+      n_ = 0;
+      p_[0] = '\0';
+    }
 
+    constexpr void terminate(size_type previous) noexcept {
+      if(std::is_constant_evaluated())
+        for(size_type i = n_; i < previous; ++i)
+          p_[i] = '\0';
+      p_[n_] = '\0';
+    }
 
-  using short_string = fixed_string<68>;
-  using string = fixed_string<252>;
-  using long_string = fixed_string<1020>;
-  using page_string = fixed_string<4092>;
-  using dpage_string = fixed_string<8188>;
-  using large_string = fixed_string<65532>;
+    constexpr void truncate(size_type n) noexcept {
+      size_type const previous = n_;
+      n_ = static_cast<length_type>(n);
+      terminate(previous);
+    }
 
+    constexpr size_type position(char const* p) const noexcept {
+      return p ? static_cast<size_type>(p - p_) : npos;
+    }
 
+  }; //  fixed_string
 
-  template<std::size_t N>
-  std::string& operator += (std::string const& x, fixed_string<N> const& y) {
-    return x.append(y.data(), y.size());
-  }
 
-  template<std::size_t N, std::size_t M>
-  bool operator == (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) == 0;
-  }
+  template<std::size_t M>
+  fixed_string(char const (&)[M]) -> fixed_string<M - 1>;
 
-  template<std::size_t N>
-  bool operator == (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) == 0;
-  }
 
-  template<std::size_t N>
-  bool operator == (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) == 0;
-  }
 
-  template<std::size_t N>
-  bool operator == (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) == 0;
-  }
+  // Capacities leave room for length and terminating '\0'
+  using short_string = fixed_string<62>;
+  using string = fixed_string<254>;
+  using long_string = fixed_string<1021>;
+  using page_string = fixed_string<4093>;
+  using dpage_string = fixed_string<8189>;
+  using large_string = fixed_string<65533>;
 
-  template<std::size_t N>
-  bool operator == (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) == 0;
-  }
+  static_assert(sizeof(short_string) == 64 && alignof(short_string) == 64);
+  static_assert(sizeof(string) == 256 && alignof(string) == 64);
+  static_assert(sizeof(long_string) == 1024 && alignof(long_string) == 64);
+  static_assert(sizeof(page_string) == 4096 && alignof(page_string) == 64);
+  static_assert(sizeof(dpage_string) == 8192);
+  static_assert(sizeof(large_string) == 65536);
 
-  template<std::size_t N>
-  bool operator == (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) == 0;
-  }
 
-  template<std::size_t N>
-  bool operator == (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) == 0;
-  }
-
-  template<std::size_t N, std::size_t M>
-  bool operator != (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) != 0;
-  }
 
+  // fixed_string with hash kept up to date by every modification,
+  // content is exposed read only
   template<std::size_t N>
-  bool operator != (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) != 0;
-  }
+  class hashed_fixed_string {
+  public:
 
-  template<std::size_t N>
-  bool operator != (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    using value_type = char;
+    using size_type = std::size_t;
+    using const_pointer = char const*;
+    using const_reference = char const&;
+    using const_iterator = char const*;
 
-  template<std::size_t N>
-  bool operator != (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) != 0;
-  }
+    static constexpr size_type npos = size_type(-1);
 
-  template<std::size_t N>
-  bool operator != (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    constexpr hashed_fixed_string() noexcept {
+      rehash();
+    }
 
-  template<std::size_t N>
-  bool operator != (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) != 0;
-  }
+    explicit constexpr hashed_fixed_string(std::string_view s) noexcept: string_{s} {
+      rehash();
+    }
 
-  template<std::size_t N>
-  bool operator != (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    template<std::size_t M>
+    explicit constexpr hashed_fixed_string(fixed_string<M> const& s) noexcept: string_{s} {
+      rehash();
+    }
 
-  template<std::size_t N, std::size_t M>
-  bool operator < (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) != 0;
-  }
+    constexpr hashed_fixed_string& operator = (std::string_view s) noexcept {
+      return assign(s);
+    }
 
-  template<std::size_t N>
-  bool operator < (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) != 0;
-  }
+    template<std::size_t M>
+    constexpr hashed_fixed_string& operator = (fixed_string<M> const& s) noexcept {
+      return assign(std::string_view{s.data(), s.size()});
+    }
+
+    constexpr char const* begin() const noexcept { return string_.begin(); }
+    constexpr char const* end() const noexcept { return string_.end(); }
+    constexpr char const* cbegin() const noexcept { return string_.begin(); }
+    constexpr char const* cend() const noexcept { return string_.end(); }
+    constexpr char const* data() const noexcept { return string_.data(); }
+    constexpr char const* c_str() const noexcept { return string_.c_str(); }
+    constexpr size_type size() const noexcept { return string_.size(); }
+    constexpr size_type length() const noexcept { return string_.size(); }
+    constexpr size_type capacity() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return string_.empty(); }
+    constexpr char const& operator [] (size_type i) const noexcept { return string_[i]; }
+    constexpr fixed_string<N> const& string() const noexcept { return string_; }
+    constexpr std::size_t hash() const noexcept { return hash_; }
 
-  template<std::size_t N>
-  bool operator < (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    constexpr std::string_view view() const noexcept {
+      return string_.view();
+    }
 
-  template<std::size_t N>
-  bool operator < (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) != 0;
-  }
+    constexpr void clear() noexcept {
+      string_.clear();
+      rehash();
+    }
 
-  template<std::size_t N>
-  bool operator < (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    constexpr void resize(size_type n) noexcept {
+      string_.resize(n);
+      rehash();
+    }
 
-  template<std::size_t N>
-  bool operator < (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) != 0;
-  }
+    constexpr void push_back(char c) noexcept {
+      string_.push_back(c);
+      rehash();
+    }
 
-  template<std::size_t N>
-  bool operator < (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    constexpr void pop_back() noexcept {
+      string_.pop_back();
+      rehash();
+    }
 
-  template<std::size_t N, std::size_t M>
-  bool operator <= (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) != 0;
-  }
+    constexpr hashed_fixed_string& operator += (char c) noexcept {
+      push_back(c);
+      return *this;
+    }
 
-  template<std::size_t N>
-  bool operator <= (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) != 0;
-  }
+    constexpr hashed_fixed_string& operator += (std::string_view s) noexcept {
+      return append(s);
+    }
 
-  template<std::size_t N>
-  bool operator <= (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    constexpr hashed_fixed_string& append(std::string_view s) noexcept {
+      string_.append(s);
+      rehash();
+      return *this;
+    }
 
-  template<std::size_t N>
-  bool operator <= (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) != 0;
-  }
+    constexpr hashed_fixed_string& assign(std::string_view s) noexcept {
+      string_.assign(s);
+      rehash();
+      return *this;
+    }
 
-  template<std::size_t N>
-  bool operator <= (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+    friend constexpr bool operator == (hashed_fixed_string const& x,
+                             hashed_fixed_string const& y) noexcept {
+      return x.hash_ == y.hash_ && x.view() == y.view();
+    }
 
-  template<std::size_t N>
-  bool operator <= (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) != 0;
-  }
+    friend constexpr bool operator != (hashed_fixed_string const& x,
+                             hashed_fixed_string const& y) noexcept {
+      return !(x == y);
+    }
 
-  template<std::size_t N>
-  bool operator <= (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+  private:
 
-  template<std::size_t N, std::size_t M>
-  bool operator > (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) != 0;
-  }
+    fixed_string<N> string_;
+    std::size_t hash_{0};
 
-  template<std::size_t N>
-  bool operator > (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) != 0;
-  }
+    constexpr void rehash() noexcept {
+      hash_ = std::size_t(detail::hash_bytes(string_.data(), string_.size()));
+    }
 
-  template<std::size_t N>
-  bool operator > (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+  }; // hashed_fixed_string
 
-  template<std::size_t N>
-  bool operator > (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) != 0;
-  }
 
-  template<std::size_t N>
-  bool operator > (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
 
   template<std::size_t N>
-  bool operator > (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) != 0;
+  std::string& operator += (std::string& x, fixed_string<N> const& y) {
+    return x.append(y.data(), y.size());
   }
 
-  template<std::size_t N>
-  bool operator > (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
-  }
+  // Reversed and != forms are synthesized from these
 
   template<std::size_t N, std::size_t M>
-  bool operator >= (fixed_string<N> const& x, fixed_string<M> const& y) {
-    return x.compare(y) != 0;
+  constexpr bool operator == (fixed_string<N> const& x, fixed_string<M> const& y) noexcept {
+    return x.view() == y.view();
   }
 
   template<std::size_t N>
-  bool operator >= (fixed_string<N> const& x, char const* y) {
-    return x.compare(y) != 0;
+  constexpr bool operator == (fixed_string<N> const& x, std::string_view const& y) noexcept {
+    return x.view() == y;
   }
 
   template<std::size_t N>
-  bool operator >= (char const* x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
+  constexpr bool operator == (fixed_string<N> const& x, std::string const& y) noexcept {
+    return x.view() == std::string_view{y};
   }
 
   template<std::size_t N>
-  bool operator >= (fixed_string<N> const& x, std::string const& y) {
-    return x.compare(y) != 0;
+  constexpr bool operator == (fixed_string<N> const& x, char const* y) noexcept {
+    return x.view() == std::string_view{y ? y : ""};
+  }
+
+  template<std::size_t N, std::size_t M>
+  constexpr std::strong_ordering operator <=> (fixed_string<N> const& x,
+                                     fixed_string<M> const& y) noexcept {
+    return x.view() <=> y.view();
   }
 
   template<std::size_t N>
-  bool operator >= (std::string const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
+  constexpr std::strong_ordering operator <=> (fixed_string<N> const& x,
+                                     std::string_view const& y) noexcept {
+    return x.view() <=> y;
   }
 
   template<std::size_t N>
-  bool operator >= (fixed_string<N> const& x, std::string_view const& y) {
-    return x.compare(y) != 0;
+  constexpr std::strong_ordering operator <=> (fixed_string<N> const& x,
+                                     std::string const& y) noexcept {
+    return x.view() <=> std::string_view{y};
   }
 
   template<std::size_t N>
-  bool operator >= (std::string_view const& x, fixed_string<N> const& y) {
-    return y.compare(x) != 0;
+  constexpr std::strong_ordering operator <=> (fixed_string<N> const& x, char const* y) noexcept {
+    return x.view() <=> std::string_view{y ? y : ""};
   }
 
   template<typename OS, std::size_t N>
@@ -635,11 +706,17 @@ namespace std {
 
 template<size_t N> struct hash<uformat::fixed_string<N>> {
 
-  size_t operator()(uformat::fixed_string<N> const& s) const {
-    size_t h = 0;
-    char const* cc = s.data();
-    while(*cc) h = h * 101 + static_cast<size_t>(*cc++);
-    return h;
+  constexpr size_t operator()(uformat::fixed_string<N> const& s) const noexcept {
+    return size_t(uformat::detail::hash_bytes(s.data(), s.size()));
+  }
+
+}; // hash
+
+
+template<size_t N> struct hash<uformat::hashed_fixed_string<N>> {
+
+  constexpr size_t operator()(uformat::hashed_fixed_string<N> const& s) const noexcept {
+    return s.hash();
   }
 
 }; // hash
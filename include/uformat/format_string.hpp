@@ -0,0 +1,177 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdexcept>
+
+
+namespace uformat {
+
+
+  // Format string as template parameter, e.g. texter.format<"px={:.4f}">(x).
+  // Fields are {} or {:[<|>][0][width][.precision][f]}, braces are escaped
+  // as {{ and }}. As in std::format, 0 pads with zeros after sign and is
+  // ignored when alignment is given
+  template<std::size_t N>
+  struct format_string {
+    char text[N]{};
+
+    constexpr format_string(char const (&s)[N]) noexcept {
+      for(std::size_t i = 0; i != N; ++i)
+        text[i] = s[i];
+    }
+  }; // format_string
+
+
+  namespace detail::formatting {
+
+
+    struct segment {
+      bool literal{true};
+      std::size_t offset{0};
+      std::size_t size{0};
+      std::size_t argument{0};
+      char align{'\0'};
+      bool zero{false};
+      unsigned width{0};
+      int precision{-1};
+    };
+
+
+    // Parsing fills worst case of N segments, parsed keeps M used ones
+    template<std::size_t N, std::size_t M = N>
+    struct format {
+      char text[N]{};
+      segment segments[M != 0 ? M : 1]{};
+      std::size_t segments_count{0};
+      std::size_t text_size{0};
+      std::size_t arguments_count{0};
+
+
+      constexpr void append_literal(char c) {
+        if(segments_count == 0 || !segments[segments_count - 1].literal) {
+          segment& s = segments[segments_count++];
+          s.offset = text_size;
+          s.size = 0;
+        }
+        ++segments[segments_count - 1].size;
+        text[text_size++] = c;
+      }
+    }; // format
+
+
+    constexpr bool is_digit(char c) {
+      return c >= '0' && c <= '9';
+    }
+
+
+    constexpr unsigned parse_number(char const*& p, char const* e) {
+      unsigned n = 0;
+      for(; p != e && is_digit(*p); ++p)
+        n = n * 10 + unsigned(*p - '0');
+      return n;
+    }
+
+
+    template<std::size_t N>
+    constexpr format<N> parse(format_string<N> const& s) {
+      format<N> f;
+      char const* p = s.text;
+      char const* const e = s.text + N - 1;
+      while(p != e) {
+        char const c = *p++;
+        if(c == '}') {
+          if(p == e || *p != '}')
+            throw std::invalid_argument("unmatched '}' in format string");
+          ++p;
+          f.append_literal('}');
+          continue;
+        }
+        if(c != '{') {
+          f.append_literal(c);
+          continue;
+        }
+        if(p != e && *p == '{') {
+          ++p;
+          f.append_literal('{');
+          continue;
+        }
+
+        segment field;
+        field.literal = false;
+        field.argument = f.arguments_count++;
+        if(p != e && *p == ':') {
+          ++p;
+          if(p != e && (*p == '<' || *p == '>'))
+            field.align = *p++;
+          if(p != e && *p == '0') {
+            field.zero = field.align == '\0';
+            ++p;
+          }
+          field.width = parse_number(p, e);
+          if(p != e && *p == '.') {
+            ++p;
+            if(p == e || !is_digit(*p))
+              throw std::invalid_argument("missing precision in format string");
+            field.precision = int(parse_number(p, e));
+          }
+          if(p != e && *p == 'f') {
+            ++p;
+            if(field.precision < 0)
+              field.precision = 6;
+          }
+        }
+        if(p == e || *p != '}')
+          throw std::invalid_argument("invalid field in format string");
+        ++p;
+        f.segments[f.segments_count++] = field;
+      }
+      return f;
+    }
+
+
+    template<std::size_t M, std::size_t N>
+    constexpr format<N, M> shrink(format<N> const& full) {
+      format<N, M> f;
+      for(std::size_t i = 0; i != N; ++i)
+        f.text[i] = full.text[i];
+      for(std::size_t i = 0; i != M; ++i)
+        f.segments[i] = full.segments[i];
+      f.segments_count = full.segments_count;
+      f.text_size = full.text_size;
+      f.arguments_count = full.arguments_count;
+      return f;
+    }
+
+
+    template<format_string S>
+    inline constexpr auto parsed = shrink<parse(S).segments_count>(parse(S));
+
+
+  } // detail::formatting
+
+
+} // uformat
@@ -0,0 +1,113 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "floating.hpp"
+
+
+namespace uformat::detail {
+
+
+  // Little-endian order when constant evaluated
+  template<typename T>
+  constexpr std::uint64_t read(char const* p) noexcept {
+    if(std::is_constant_evaluated()) {
+      std::uint64_t x = 0;
+      for(std::size_t i = 0; i != sizeof(T); ++i)
+        x |= std::uint64_t(std::uint8_t(p[i])) << (8 * i);
+      return x;
+    }
+    T x;
+    std::memcpy(&x, p, sizeof(x));
+    return x;
+  }
+
+
+  constexpr std::uint64_t read64(char const* p) noexcept {
+    return read<std::uint64_t>(p);
+  }
+
+
+  constexpr std::uint64_t read32(char const* p) noexcept {
+    return read<std::uint32_t>(p);
+  }
+
+
+  // Folded 128-bit product
+  constexpr std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept {
+    floating::uint128 const p = floating::multiply(a, b);
+    return p.hi ^ p.lo;
+  }
+
+
+  // wyhash (final version 4): 16 bytes per multiply, three independent
+  // lanes above 48 bytes, strings up to 16 bytes take two overlapping loads
+  constexpr std::uint64_t hash_bytes(char const* p, std::size_t n,
+                                     std::uint64_t seed = 0) noexcept {
+    constexpr std::uint64_t s0 = 0xa0761d6478bd642full, s1 = 0xe7037ed1a0b428dbull;
+    constexpr std::uint64_t s2 = 0x8ebc6af09c88c6e3ull, s3 = 0x589965cc75374cc3ull;
+    seed ^= hash_mix(seed ^ s0, s1);
+    std::uint64_t a, b;
+    if(n <= 16) {
+      if(n >= 4) {
+        std::size_t const shift = (n >> 3) << 2;
+        a = (read32(p) << 32) | read32(p + shift);
+        b = (read32(p + n - 4) << 32) | read32(p + n - 4 - shift);
+      } else if(n > 0) {
+        a = (std::uint64_t(std::uint8_t(p[0])) << 16)
+          | (std::uint64_t(std::uint8_t(p[n >> 1])) << 8)
+          | std::uint64_t(std::uint8_t(p[n - 1]));
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      std::size_t i = n;
+      if(i > 48) {
+        std::uint64_t lane1 = seed, lane2 = seed;
+        do {
+          seed = hash_mix(read64(p) ^ s1, read64(p + 8) ^ seed);
+          lane1 = hash_mix(read64(p + 16) ^ s2, read64(p + 24) ^ lane1);
+          lane2 = hash_mix(read64(p + 32) ^ s3, read64(p + 40) ^ lane2);
+          p += 48; i -= 48;
+        } while(i > 48);
+        seed ^= lane1 ^ lane2;
+      }
+      while(i > 16) {
+        seed = hash_mix(read64(p) ^ s1, read64(p + 8) ^ seed);
+        p += 16; i -= 16;
+      }
+      a = read64(p + i - 16);
+      b = read64(p + i - 8);
+    }
+    floating::uint128 const r = floating::multiply(a ^ s1, b ^ seed);
+    return hash_mix(r.lo ^ s0 ^ n, r.hi ^ s1);
+  }
+
+
+} // uformat::detail
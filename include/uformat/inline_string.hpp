@@ -0,0 +1,336 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+
+namespace uformat {
+
+
+  // First N characters are kept inline, longer content spills to heap buffer
+  // growing twice at a time; content returns inline only by shrink_to_fit()
+  template<std::size_t N = 255>
+  class inline_string {
+  public:
+
+    using value_type = char;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = char*;
+    using const_pointer = char const*;
+    using reference = char&;
+    using const_reference = char const&;
+    using iterator = char*;
+    using const_iterator = char const*;
+
+    static constexpr size_type npos = size_type(-1);
+
+    inline_string() noexcept {
+      inline_[0] = '\0';
+    }
+
+    ~inline_string() { release(); }
+
+    inline_string(inline_string const& other) {
+      inline_[0] = '\0';
+      append(other.data_, other.size_);
+    }
+
+    inline_string(inline_string&& other) noexcept {
+      take(other);
+    }
+
+    inline_string& operator = (inline_string const& other) {
+      if(this != &other)
+        assign(other.data_, other.size_);
+      return *this;
+    }
+
+    inline_string& operator = (inline_string&& other) noexcept {
+      if(this != &other) {
+        release();
+        take(other);
+      }
+      return *this;
+    }
+
+    explicit inline_string(char const* data) {
+      inline_[0] = '\0';
+      append(data);
+    }
+
+    inline_string(char const* b, char const* e) {
+      inline_[0] = '\0';
+      append(b, e);
+    }
+
+    explicit inline_string(std::string_view const& rhs) {
+      inline_[0] = '\0';
+      append(rhs.data(), rhs.size());
+    }
+
+    explicit inline_string(std::string const& rhs) {
+      inline_[0] = '\0';
+      append(rhs.data(), rhs.size());
+    }
+
+    inline_string& operator = (char const* data) { return assign(data); }
+    inline_string& operator = (std::string_view const& rhs) { return assign(rhs); }
+    inline_string& operator = (std::string const& rhs) { return assign(rhs); }
+
+    char* begin() noexcept { return data_; }
+    char* end() noexcept { return data_ + size_; }
+    char const* begin() const noexcept { return data_; }
+    char const* end() const noexcept { return data_ + size_; }
+    char const* cbegin() const noexcept { return data_; }
+    char const* cend() const noexcept { return data_ + size_; }
+
+    char const* c_str() const noexcept { return data_; }
+    char const* data() const noexcept { return data_; }
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+    size_type size() const noexcept { return size_; }
+    size_type length() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    size_type max_size() const noexcept { return npos / 2; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool is_inline() const noexcept { return data_ == inline_; }
+
+    // Heap buffer is kept for the next content
+    void clear() noexcept { size_ = 0; data_[0] = '\0'; }
+
+
+    void reserve(size_type n) {
+      if(n > capacity_)
+        reallocate(n);
+    }
+
+
+    // New characters are left uninitialized
+    void resize(size_type n) {
+      if(n > capacity_)
+        grow(n);
+      size_ = n;
+      data_[n] = '\0';
+    }
+
+
+    void shrink_to_fit() {
+      if(is_inline() || size_ == capacity_)
+        return;
+      char* const heap = data_;
+      if(size_ <= N) {
+        std::char_traits<char>::copy(inline_, heap, size_ + 1);
+        data_ = inline_;
+        capacity_ = N;
+        delete[] heap;
+      } else {
+        reallocate(size_);
+      }
+    }
+
+
+    char& operator [] (size_type i) noexcept { return data_[i]; }
+    char const& operator [] (size_type i) const noexcept { return data_[i]; }
+
+    char& at(size_type i) {
+      if(i >= size_)
+        throw std::out_of_range("invalid string position");
+      return data_[i];
+    }
+
+    char const& at(size_type i) const {
+      if(i >= size_)
+        throw std::out_of_range("invalid string position");
+      return data_[i];
+    }
+
+    char& back() noexcept { return data_[size_ - 1]; }
+    char const& back() const noexcept { return data_[size_ - 1]; }
+    char& front() noexcept { return data_[0]; }
+    char const& front() const noexcept { return data_[0]; }
+
+
+    inline_string& operator += (char c) {
+      push_back(c);
+      return *this;
+    }
+
+    inline_string& operator += (char const* cc) { return append(cc); }
+    inline_string& operator += (std::string const& rhs) { return append(rhs); }
+    inline_string& operator += (std::string_view const& rhs) { return append(rhs); }
+
+    inline_string& append(std::string const& rhs) {
+      return append(rhs.data(), rhs.size());
+    }
+
+    inline_string& append(std::string_view const& rhs) {
+      return append(rhs.data(), rhs.size());
+    }
+
+    inline_string& append(char const* cc) {
+      if(cc == nullptr)
+        return *this;
+      return append(cc, std::char_traits<char>::length(cc));
+    }
+
+    inline_string& append(char const* b, char const* e) {
+      if(b == nullptr || e == nullptr)
+        return *this;
+      return append(b, size_type(e - b));
+    }
+
+
+    inline_string& append(char const* cc, size_type n) {
+      if(n > capacity_ - size_)
+        return spill(cc, n);
+      // source may be inside this string when assigning
+      std::char_traits<char>::move(data_ + size_, cc, n);
+      size_ += n;
+      data_[size_] = '\0';
+      return *this;
+    }
+
+
+    void push_back(char c) {
+      if(size_ == capacity_)
+        grow(size_ + 1);
+      data_[size_++] = c;
+      data_[size_] = '\0';
+    }
+
+
+    void pop_back() noexcept {
+      if(size_ == 0) return;
+      data_[--size_] = '\0';
+    }
+
+
+    inline_string& assign(char const* cc) {
+      if(cc == nullptr) {
+        clear();
+        return *this;
+      }
+      return assign(cc, std::char_traits<char>::length(cc));
+    }
+
+    inline_string& assign(std::string_view const& rhs) {
+      return assign(rhs.data(), rhs.size());
+    }
+
+    inline_string& assign(std::string const& rhs) {
+      return assign(rhs.data(), rhs.size());
+    }
+
+    inline_string& assign(char const* cc, size_type n) {
+      if(n > capacity_) {
+        size_ = 0;
+        grow(n);
+      }
+      std::char_traits<char>::move(data_, cc, n);
+      size_ = n;
+      data_[n] = '\0';
+      return *this;
+    }
+
+
+    std::string_view substr(size_type pos, size_type n) const noexcept {
+      return std::string_view{data_ + pos, n};
+    }
+
+
+    friend bool operator == (inline_string const& x, std::string_view const& y) noexcept {
+      return x.view() == y;
+    }
+
+  private:
+
+    char* data_{inline_};
+    size_type size_{0};
+    size_type capacity_{N};
+    char inline_[N + 1];
+
+
+    // Source may be inside old buffer, so it is released last
+    inline_string& spill(char const* cc, size_type n) {
+      size_type const doubled = capacity_ * 2;
+      size_type const needed = size_ + n;
+      size_type const capacity = needed > doubled ? needed : doubled;
+      char* const heap = new char[capacity + 1];
+      std::char_traits<char>::copy(heap, data_, size_);
+      std::char_traits<char>::copy(heap + size_, cc, n);
+      release();
+      data_ = heap;
+      capacity_ = capacity;
+      size_ = needed;
+      data_[size_] = '\0';
+      return *this;
+    }
+
+
+    void grow(size_type n) {
+      size_type const doubled = capacity_ * 2;
+      reallocate(n > doubled ? n : doubled);
+    }
+
+
+    void reallocate(size_type n) {
+      char* const heap = new char[n + 1];
+      std::char_traits<char>::copy(heap, data_, size_ + 1);
+      release();
+      data_ = heap;
+      capacity_ = n;
+    }
+
+
+    void release() noexcept {
+      if(!is_inline())
+        delete[] data_;
+    }
+
+
+    void take(inline_string& other) noexcept {
+      size_ = other.size_;
+      if(other.is_inline()) {
+        std::char_traits<char>::copy(inline_, other.inline_, other.size_ + 1);
+        data_ = inline_;
+        capacity_ = N;
+        return;
+      }
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      other.data_ = other.inline_;
+      other.capacity_ = N;
+      other.size_ = 0;
+      other.inline_[0] = '\0';
+    }
+
+  }; // inline_string
+
+
+} // uformat
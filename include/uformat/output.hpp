@@ -0,0 +1,127 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
+namespace uformat {
+
+
+  // What a logger does when its queue is full
+  enum class overflow {
+    block, drop, drop_and_count
+  };
+
+
+  namespace detail::output {
+
+
+#if defined(_WIN32)
+    struct iovec {
+      void* iov_base;
+      size_t iov_len;
+    };
+#else
+    using ::iovec;
+#endif
+
+
+    inline int descriptor(std::FILE* stream) {
+#if defined(_WIN32)
+      return _fileno(stream);
+#else
+      return fileno(stream);
+#endif
+    }
+
+
+    // Whole buffer goes out by one write() bypassing stdio buffers and locks,
+    // so lines from different threads never interleave
+    inline void write(int descriptor, char const* p, size_t n) {
+      while(n != 0) {
+#if defined(_WIN32)
+        int const written = _write(descriptor, p, unsigned(n));
+#else
+        auto const written = ::write(descriptor, p, n);
+#endif
+        if(written < 0) {
+          if(errno == EINTR)
+            continue;
+          return;
+        }
+        p += written;
+        n -= size_t(written);
+      }
+    }
+
+
+    // Segments go out by as few writev() calls as IOV_MAX allows,
+    // partially written segment is finished by write()
+    inline void write(int descriptor, iovec const* v, size_t count) {
+#if defined(_WIN32)
+      for(; count != 0; ++v, --count)
+        write(descriptor, static_cast<char const*>(v->iov_base), v->iov_len);
+#else
+#if defined(IOV_MAX)
+      constexpr size_t max_batch = IOV_MAX;
+#else
+      constexpr size_t max_batch = 1024;
+#endif
+      while(count != 0) {
+        size_t const batch = count < max_batch ? count : max_batch;
+        auto const written = ::writev(descriptor, v, int(batch));
+        if(written < 0) {
+          if(errno == EINTR)
+            continue;
+          return;
+        }
+        size_t left = size_t(written);
+        for(; count != 0 && left >= v->iov_len; ++v, --count)
+          left -= v->iov_len;
+        if(left != 0) {
+          write(descriptor, static_cast<char const*>(v->iov_base) + left, v->iov_len - left);
+          ++v;
+          --count;
+        }
+      }
+#endif
+    }
+
+
+  } // detail::output
+
+
+} // uformat
@@ -24,25 +24,56 @@
 
 
 #include "texter.hpp"
+#include "output.hpp"
 
 
 namespace uformat {
-  
+
+
   namespace detail::printer {
 
-    inline std::mutex sync;
-    inline dynamic_texter buffer;
+    inline thread_local dynamic_texter buffer;
+
+
+    template<typename... Args>
+    void print(std::FILE* stream, Args&&... args) {
+      buffer.clear();
+      buffer.print(std::forward<Args>(args)..., '\n');
+      output::write(output::descriptor(stream), buffer.data(), buffer.size());
+    }
 
   }
 
 
+} // uformat
+
+
+#if defined(UFORMAT_DEFERRED_PRINT)
+
+#include "deferred_logger.hpp"
+
+namespace uformat::detail::printer {
+
+  inline deferred_logger& deferred() {
+    static deferred_logger logger;
+    return logger;
+  }
+
+}
+
+#endif
+
+
+namespace uformat {
+
+
   template<typename... Args>
   void print(Args&&... args) {
-    std::unique_lock g{detail::printer::sync};
-    detail::printer::buffer.clear();
-    detail::printer::buffer.print(std::forward<Args>(args)...);
-    std::fputs(detail::printer::buffer.data(), stdout);
-    std::fputc('\n', stdout);
+#if defined(UFORMAT_DEFERRED_PRINT)
+    detail::printer::deferred().print(std::forward<Args>(args)...);
+#else
+    detail::printer::print(stdout, std::forward<Args>(args)...);
+#endif
   }
 
 
@@ -55,11 +86,11 @@ namespace uformat {
 
   template<typename... Args>
   void error(Args&&... args) {
-    std::unique_lock g{detail::printer::sync};
-    detail::printer::buffer.clear();
-    detail::printer::buffer.print(std::forward<Args>(args)...);
-    std::fputs(detail::printer::buffer.data(), stderr);
-    std::fputc('\n', stderr);
+#if defined(UFORMAT_DEFERRED_PRINT)
+    detail::printer::deferred().error(std::forward<Args>(args)...);
+#else
+    detail::printer::print(stderr, std::forward<Args>(args)...);
+#endif
   }
 
 
@@ -0,0 +1,365 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <string_view>
+#include <string>
+
+
+#if defined(_WIN32)
+
+#if !defined(_X86_) && !defined(_AMD64_) && !defined(_ARM_) && !defined(_ARM64_)
+#if defined(_M_IX86)
+#define _X86_
+#elif defined(_M_AMD64)
+#define _AMD64_
+#elif defined(_M_ARM)
+#define _ARM_
+#elif defined(_M_ARM64)
+#define _ARM64_
+#endif
+#endif
+
+#include <minwindef.h>
+#include <sysinfoapi.h>
+#include <memoryapi.h>
+#include <handleapi.h>
+
+#elif defined(__unix__) || defined(__APPLE__)
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+
+#else
+
+#error Unsupported system
+
+#endif // WIN32
+
+
+
+namespace uformat {
+
+
+// N bytes mapped twice back to back, so content is contiguous
+// wherever it starts; front is dropped by consume(). Ring is rounded
+// up to mapping granularity when N is smaller. If mapping fails,
+// string is not valid(), stays empty and ignores writes
+template<std::uint64_t N = 1048576>
+class ring_string {
+public:
+
+  static_assert(N != 0 && (N & (N - 1)) == 0, "Ring size should be a power of 2");
+
+  using value_type = char;
+  using size_type = std::uint64_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = char*;
+  using const_pointer = char const*;
+  using reference = char&;
+  using const_reference = char const&;
+  using iterator = char*;
+  using const_iterator = char const*;
+
+  static constexpr size_type npos = size_type(-1);
+
+
+  ring_string() noexcept {
+    base_ = map_ring(ring_);
+    if(base_ != nullptr)
+      base_[0] = '\0';
+  }
+
+  ~ring_string() { dispose(); }
+
+  ring_string(ring_string const&) = delete;
+  ring_string& operator = (ring_string const&) = delete;
+
+
+  ring_string(ring_string&& other) noexcept:
+    base_{other.base_}, ring_{other.ring_}, head_{other.head_}, size_{other.size_} {
+    other.base_ = nullptr;
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+
+
+  ring_string& operator = (ring_string&& other) noexcept {
+    dispose();
+    base_ = other.base_; other.base_ = nullptr;
+    ring_ = other.ring_;
+    head_ = other.head_; other.head_ = 0;
+    size_ = other.size_; other.size_ = 0;
+    return *this;
+  }
+
+
+  bool valid() const noexcept { return base_ != nullptr; }
+
+  char* data() noexcept { return base_ + head_; }
+  char const* data() const noexcept { return base_ + head_; }
+  char* begin() noexcept { return base_ + head_; }
+  char* end() noexcept { return base_ + head_ + size_; }
+  char const* begin() const noexcept { return base_ + head_; }
+  char const* end() const noexcept { return base_ + head_ + size_; }
+  char const* cbegin() const noexcept { return base_ + head_; }
+  char const* cend() const noexcept { return base_ + head_ + size_; }
+
+  size_type size() const noexcept { return size_; }
+  size_type length() const noexcept { return size_; }
+  size_type capacity() const noexcept { return N - 1; }
+  size_type max_size() const noexcept { return N - 1; }
+  bool empty() const noexcept { return size_ == 0; }
+  void clear() noexcept { size_ = 0; terminate(); }
+
+  std::string_view view() const noexcept { return {base_ + head_, size_}; }
+
+
+  // Content never moves, so there is nothing to reserve beyond the ring
+  bool reserve(size_type n) const noexcept { return base_ != nullptr && n < N; }
+
+
+  bool resize(size_type n) noexcept {
+    if(base_ == nullptr || n >= N)
+      return false;
+    size_ = n;
+    terminate();
+    return true;
+  }
+
+
+  // Drops n bytes from the front, usually after they are written out
+  void consume(size_type n) noexcept {
+    if(n > size_)
+      n = size_;
+    if(n == 0)
+      return;
+    head_ = (head_ + n) & (ring_ - 1);
+    size_ -= n;
+  }
+
+
+  char& operator [] (size_type i) noexcept { return base_[head_ + i]; }
+  char const& operator [] (size_type i) const noexcept { return base_[head_ + i]; }
+
+  char& back() noexcept { return base_[head_ + size_ - 1]; }
+  char const& back() const noexcept { return base_[head_ + size_ - 1]; }
+  char& front() noexcept { return base_[head_]; }
+  char const& front() const noexcept { return base_[head_]; }
+
+
+  ring_string& operator += (char c) noexcept {
+    push_back(c);
+    return *this;
+  }
+
+  ring_string& operator += (char const* cc) noexcept {
+    return append(cc);
+  }
+
+  ring_string& operator += (std::string const& rhs) noexcept {
+    return append(rhs.data(), rhs.size());
+  }
+
+  ring_string& operator += (std::string_view const& rhs) noexcept {
+    return append(rhs.data(), rhs.size());
+  }
+
+
+  ring_string& append(std::string const& rhs) noexcept {
+    return append(rhs.data(), rhs.size());
+  }
+
+  ring_string& append(std::string_view const& rhs) noexcept {
+    return append(rhs.data(), rhs.size());
+  }
+
+  ring_string& append(char const* cc) noexcept {
+    if(cc == nullptr)
+      return *this;
+    return append(cc, std::char_traits<char>::length(cc));
+  }
+
+  ring_string& append(char const* b, char const* e) noexcept {
+    if(b == nullptr || e == nullptr)
+      return *this;
+    return append(b, size_type(e - b));
+  }
+
+  ring_string& append(char const* cc, size_type n) noexcept {
+    if(base_ == nullptr || n == 0 || n > N - 1 - size_)
+      return *this;
+    std::char_traits<char>::copy(base_ + head_ + size_, cc, n);
+    size_ += n;
+    terminate();
+    return *this;
+  }
+
+
+  bool push_back(char c) noexcept {
+    if(base_ == nullptr || size_ == N - 1)
+      return false;
+    base_[head_ + size_] = c;
+    ++size_;
+    terminate();
+    return true;
+  }
+
+
+  void pop_back() noexcept {
+    if(size_ == 0) return;
+    --size_;
+    terminate();
+  }
+
+
+private:
+
+  char* base_{nullptr};
+  size_type ring_{N};
+  size_type head_{0};
+  size_type size_{0};
+
+
+  // Byte after content is free even when ring is full
+  void terminate() noexcept {
+    if(base_ != nullptr)
+      base_[head_ + size_] = '\0';
+  }
+
+
+  void dispose() noexcept {
+    if(base_ == nullptr)
+      return;
+    unmap_ring(base_, ring_);
+    base_ = nullptr;
+    head_ = 0;
+    size_ = 0;
+  }
+
+
+#if defined(_WIN32)
+
+  // Views are placed at allocation granularity, 64 KiB usually
+  static size_type granularity() noexcept {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+  }
+
+
+  static char* map_ring(size_type& ring) noexcept {
+    size_type const g = granularity();
+    size_type const n = ring = N < g ? g : N;
+    if(n % g != 0)
+      return nullptr;
+    HANDLE const mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                              DWORD(n >> 32), DWORD(n), nullptr);
+    if(mapping == nullptr)
+      return nullptr;
+    char* mapped = nullptr;
+    // Address found for both views may be taken by other thread meanwhile
+    for(int attempt = 0; attempt != 16 && mapped == nullptr; ++attempt) {
+      void* const address = VirtualAlloc(nullptr, 2 * n, MEM_RESERVE, PAGE_NOACCESS);
+      if(address == nullptr)
+        break;
+      VirtualFree(address, 0, MEM_RELEASE);
+      char* const first = static_cast<char*>(
+        MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, n, address));
+      if(first == nullptr)
+        continue;
+      void* const second = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, n, first + n);
+      if(second == nullptr) {
+        UnmapViewOfFile(first);
+        continue;
+      }
+      mapped = first;
+    }
+    CloseHandle(mapping);
+    return mapped;
+  }
+
+
+  static void unmap_ring(char* base, size_type ring) noexcept {
+    UnmapViewOfFile(base + ring);
+    UnmapViewOfFile(base);
+  }
+
+#else
+
+  static int open_memory() noexcept {
+#if defined(__linux__)
+    return memfd_create("uformat.ring_string", MFD_CLOEXEC);
+#else
+    char name[64];
+    std::snprintf(name, sizeof(name), "/uformat.ring_string.%ld.%p",
+                  long(getpid()), static_cast<void*>(name));
+    int const fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd != -1)
+      shm_unlink(name);
+    return fd;
+#endif
+  }
+
+
+  static char* map_ring(size_type& ring) noexcept {
+    size_type const page = size_type(sysconf(_SC_PAGESIZE));
+    size_type const n = ring = N < page ? page : N;
+    if(n % page != 0)
+      return nullptr;
+    int const fd = open_memory();
+    if(fd == -1)
+      return nullptr;
+    char* mapped = nullptr;
+    void* const reserved = mmap(nullptr, 2 * n, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(ftruncate(fd, off_t(n)) == 0 && reserved != MAP_FAILED) {
+      char* const base = static_cast<char*>(reserved);
+      if(mmap(base, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+         && mmap(base + n, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED)
+        mapped = base;
+      else
+        munmap(base, 2 * n);
+    } else if(reserved != MAP_FAILED) {
+      munmap(reserved, 2 * n);
+    }
+    close(fd);
+    return mapped;
+  }
+
+
+  static void unmap_ring(char* base, size_type ring) noexcept {
+    munmap(base, 2 * ring);
+  }
+
+#endif
+
+}; // ring_string
+
+
+} // uformat
@@ -0,0 +1,388 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "output.hpp"
+
+
+namespace uformat {
+
+
+  // Free chunks of N bytes kept for reuse by rope strings, not thread safe
+  template<std::size_t N>
+  class chunk_pool {
+  public:
+
+    chunk_pool() noexcept = default;
+    ~chunk_pool() { dispose(); }
+
+    chunk_pool(chunk_pool const&) = delete;
+    chunk_pool& operator = (chunk_pool const&) = delete;
+
+    chunk_pool(chunk_pool&& other) noexcept: free_{std::move(other.free_)} { }
+
+    chunk_pool& operator = (chunk_pool&& other) noexcept {
+      if(this != &other) {
+        dispose();
+        free_ = std::move(other.free_);
+      }
+      return *this;
+    }
+
+    std::size_t size() const noexcept { return free_.size(); }
+
+
+    char* acquire() {
+      if(free_.empty())
+        return new char[N];
+      char* const chunk = free_.back();
+      free_.pop_back();
+      return chunk;
+    }
+
+
+    void release(char* chunk) noexcept {
+      try {
+        free_.push_back(chunk);
+      } catch(...) {
+        delete[] chunk;
+      }
+    }
+
+  private:
+
+    std::vector<char*> free_;
+
+
+    void dispose() noexcept {
+      for(char* chunk: free_)
+        delete[] chunk;
+      free_.clear();
+    }
+
+  }; // chunk_pool
+
+
+  // Content is kept in chunks of N bytes that are never moved or copied on
+  // growth. Value allocated by texter always lies in one chunk, so tail of
+  // previous chunk is left unused when value does not fit there; values
+  // longer than N get a chunk of their own. Content is not contiguous and
+  // not null terminated, it goes out through segments() or write()
+  template<std::size_t N = 65536>
+  class rope_string {
+  public:
+
+    static_assert(N != 0, "Chunk size should not be zero");
+
+    using value_type = char;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = char&;
+    using const_reference = char const&;
+    using segment_type = detail::output::iovec;
+    using pool_type = chunk_pool<N>;
+
+    static constexpr size_type npos = size_type(-1);
+    static constexpr size_type chunk_size = N;
+
+    rope_string() noexcept = default;
+
+    // Pool should outlive string
+    explicit rope_string(pool_type& pool) noexcept: pool_{&pool} { }
+
+    ~rope_string() { dispose(); }
+
+    rope_string(rope_string const&) = delete;
+    rope_string& operator = (rope_string const&) = delete;
+
+
+    rope_string(rope_string&& other) noexcept:
+      own_pool_{std::move(other.own_pool_)},
+      pool_{other.pool_ == &other.own_pool_ ? &own_pool_ : other.pool_} {
+      take(other);
+    }
+
+
+    rope_string& operator = (rope_string&& other) noexcept {
+      if(this == &other)
+        return *this;
+      dispose();
+      own_pool_ = std::move(other.own_pool_);
+      pool_ = other.pool_ == &other.own_pool_ ? &own_pool_ : other.pool_;
+      take(other);
+      return *this;
+    }
+
+
+    size_type size() const noexcept { return size_; }
+    size_type length() const noexcept { return size_; }
+    size_type max_size() const noexcept { return npos / 2; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Size reachable without taking next chunk
+    size_type capacity() const noexcept { return size_ - used_ + capacity_; }
+
+    // Growth never copies, so there is nothing to prepare
+    void reserve(size_type) const noexcept { }
+    void shrink_to_fit() const noexcept { }
+
+    // First chunk is kept for the next content
+    void clear() noexcept { truncate(0); }
+
+
+    segment_type const* segments() const noexcept {
+      seal();
+      return segments_.data();
+    }
+
+
+    size_type segments_count() const noexcept { return segments_.size(); }
+
+
+    void write(int descriptor) const {
+      detail::output::write(descriptor, segments(), segments_count());
+    }
+
+
+    // Characters added are allocated but left uninitialized
+    void resize(size_type n) {
+      if(n <= size_)
+        return truncate(n);
+      size_type const k = n - size_;
+      if(k > capacity_ - used_)
+        open(k);
+      used_ += k;
+      size_ = n;
+    }
+
+
+    // Current chunk is checked first, earlier ones are searched
+    char& operator [] (size_type i) noexcept { return *locate(i); }
+    char const& operator [] (size_type i) const noexcept { return *locate(i); }
+
+
+    char& back() noexcept { return current_[used_ - 1]; }
+    char const& back() const noexcept { return current_[used_ - 1]; }
+
+
+    rope_string& operator += (char c) {
+      push_back(c);
+      return *this;
+    }
+
+    rope_string& operator += (char const* cc) { return append(cc); }
+    rope_string& operator += (std::string const& rhs) { return append(rhs); }
+    rope_string& operator += (std::string_view const& rhs) { return append(rhs); }
+
+    rope_string& append(std::string const& rhs) {
+      return append(rhs.data(), rhs.size());
+    }
+
+    rope_string& append(std::string_view const& rhs) {
+      return append(rhs.data(), rhs.size());
+    }
+
+    rope_string& append(char const* cc) {
+      if(cc == nullptr)
+        return *this;
+      return append(cc, std::char_traits<char>::length(cc));
+    }
+
+    rope_string& append(char const* b, char const* e) {
+      if(b == nullptr || e == nullptr)
+        return *this;
+      return append(b, size_type(e - b));
+    }
+
+
+    // Long content is split over as many chunks as it needs
+    rope_string& append(char const* cc, size_type n) {
+      while(n != 0) {
+        if(used_ == capacity_)
+          open(1);
+        size_type const room = capacity_ - used_;
+        size_type const m = n < room ? n : room;
+        std::char_traits<char>::copy(current_ + used_, cc, m);
+        used_ += m;
+        size_ += m;
+        cc += m;
+        n -= m;
+      }
+      return *this;
+    }
+
+
+    void push_back(char c) {
+      if(used_ == capacity_)
+        open(1);
+      current_[used_++] = c;
+      ++size_;
+    }
+
+
+    void pop_back() noexcept {
+      if(size_ != 0)
+        truncate(size_ - 1);
+    }
+
+
+    friend bool operator == (rope_string const& x, std::string_view const& y) noexcept {
+      if(x.size_ != y.size())
+        return false;
+      std::string_view rest = y;
+      segment_type const* segment = x.segments();
+      for(size_type i = 0; i != x.segments_count(); ++i, ++segment) {
+        std::string_view const part{static_cast<char const*>(segment->iov_base), segment->iov_len};
+        if(rest.substr(0, part.size()) != part)
+          return false;
+        rest.remove_prefix(part.size());
+      }
+      return true;
+    }
+
+  private:
+
+    // Logical position of chunk's first character and its capacity
+    struct extent {
+      size_type offset;
+      size_type capacity;
+    };
+
+    pool_type own_pool_;
+    pool_type* pool_{&own_pool_};
+    // Length of the last segment is brought up to date by seal()
+    mutable std::vector<segment_type> segments_;
+    std::vector<extent> extents_;
+    char* current_{nullptr};
+    size_type used_{0};
+    size_type capacity_{0};
+    size_type size_{0};
+
+
+    void seal() const noexcept {
+      if(!segments_.empty())
+        segments_.back().iov_len = used_;
+    }
+
+
+    // Chunk left empty is given back before the next one is taken
+    void open(size_type n) {
+      if(!extents_.empty() && used_ == 0)
+        drop();
+      seal();
+      size_type const capacity = n > N ? n : N;
+      char* const chunk = capacity == N ? pool_->acquire() : new char[capacity];
+      try {
+        segments_.push_back(segment_type{chunk, 0});
+        extents_.push_back(extent{size_, capacity});
+      } catch(...) {
+        if(segments_.size() > extents_.size())
+          segments_.pop_back();
+        release(chunk, capacity);
+        throw;
+      }
+      current_ = chunk;
+      used_ = 0;
+      capacity_ = capacity;
+    }
+
+
+    void truncate(size_type n) noexcept {
+      if(extents_.empty())
+        return;
+      while(extents_.size() > 1 && extents_.back().offset >= n)
+        drop();
+      used_ = n - extents_.back().offset;
+      size_ = n;
+    }
+
+
+    // Last chunk is released, previous one becomes current
+    void drop() noexcept {
+      release(static_cast<char*>(segments_.back().iov_base), extents_.back().capacity);
+      segments_.pop_back();
+      extents_.pop_back();
+      if(extents_.empty()) {
+        current_ = nullptr;
+        used_ = 0;
+        capacity_ = 0;
+        return;
+      }
+      current_ = static_cast<char*>(segments_.back().iov_base);
+      used_ = segments_.back().iov_len;
+      capacity_ = extents_.back().capacity;
+    }
+
+
+    void release(char* chunk, size_type capacity) noexcept {
+      if(capacity == N)
+        pool_->release(chunk);
+      else
+        delete[] chunk;
+    }
+
+
+    char* locate(size_type i) const noexcept {
+      size_type const offset = size_ - used_;
+      if(i >= offset)
+        return current_ + (i - offset);
+      auto const found = std::upper_bound(extents_.begin(), extents_.end(), i,
+        [](size_type x, extent const& e) { return x < e.offset; }) - 1;
+      auto const j = size_type(found - extents_.begin());
+      return static_cast<char*>(segments_[j].iov_base) + (i - found->offset);
+    }
+
+
+    void dispose() noexcept {
+      while(!extents_.empty())
+        drop();
+      size_ = 0;
+    }
+
+
+    void take(rope_string& other) noexcept {
+      segments_ = std::move(other.segments_);
+      extents_ = std::move(other.extents_);
+      current_ = other.current_;
+      used_ = other.used_;
+      capacity_ = other.capacity_;
+      size_ = other.size_;
+      other.segments_.clear();
+      other.extents_.clear();
+      other.current_ = nullptr;
+      other.used_ = 0;
+      other.capacity_ = 0;
+      other.size_ = 0;
+    }
+
+  }; // rope_string
+
+
+} // uformat
@@ -0,0 +1,311 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define UFORMAT_SEARCH_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 kernels are compiled with target attribute and selected at run time,
+// MSVC gets them only when whole program is built with /arch:AVX2
+#if defined(UFORMAT_SEARCH_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define UFORMAT_SEARCH_AVX2
+#define UFORMAT_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(UFORMAT_SEARCH_SSE2) && defined(__AVX2__)
+#define UFORMAT_SEARCH_AVX2
+#define UFORMAT_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+
+namespace uformat {
+
+
+namespace detail {
+
+  // Search kernels shared by fixed_string and continuous_string,
+  // all of them look in [b, e) and return nullptr when nothing is found
+
+
+  // Longer character sets are matched by table lookup
+  constexpr std::size_t max_vector_charset = 16;
+
+
+  struct charset_table {
+    bool bits[256]{};
+
+    explicit charset_table(std::string_view set) noexcept {
+      for(char c: set)
+        bits[static_cast<unsigned char>(c)] = true;
+    }
+
+    bool operator [] (char c) const noexcept {
+      return bits[static_cast<unsigned char>(c)];
+    }
+  };
+
+
+  inline char const* rfind_scalar(char const* b, char const* e, char c) noexcept {
+    while(e != b)
+      if(*--e == c)
+        return e;
+    return nullptr;
+  }
+
+
+  inline char const* find_of_scalar(char const* b, char const* e,
+                                    std::string_view set, bool matching) noexcept {
+    charset_table const table{set};
+    for(; b != e; ++b)
+      if(table[*b] == matching)
+        return b;
+    return nullptr;
+  }
+
+
+  inline char const* find_substring_scalar(char const* b, char const* e,
+                                           std::string_view s) noexcept {
+    auto const i = std::string_view{b, static_cast<std::size_t>(e - b)}.find(s);
+    return i == std::string_view::npos ? nullptr : b + i;
+  }
+
+
+#if defined(UFORMAT_SEARCH_SSE2)
+
+  inline unsigned first_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return unsigned(i);
+#else
+    return unsigned(__builtin_ctz(mask));
+#endif
+  }
+
+
+  inline unsigned last_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanReverse(&i, mask);
+    return unsigned(i);
+#else
+    return unsigned(31 - __builtin_clz(mask));
+#endif
+  }
+
+
+  inline char const* rfind_sse2(char const* b, char const* e, char c) noexcept {
+    __m128i const needle = _mm_set1_epi8(c);
+    while(e - b >= 16) {
+      e -= 16;
+      __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(e));
+      unsigned const mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+      if(mask)
+        return e + last_bit(mask);
+    }
+    return rfind_scalar(b, e, c);
+  }
+
+
+  // matching == false looks for the first character not in set
+  inline char const* find_of_sse2(char const* b, char const* e,
+                                  std::string_view set, bool matching) noexcept {
+    __m128i needles[max_vector_charset];
+    for(std::size_t i = 0; i != set.size(); ++i)
+      needles[i] = _mm_set1_epi8(set[i]);
+    unsigned const invert = matching ? 0u : 0xFFFFu;
+    for(; e - b >= 16; b += 16) {
+      __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b));
+      __m128i hits = _mm_setzero_si128();
+      for(std::size_t i = 0; i != set.size(); ++i)
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, needles[i]));
+      unsigned const mask = unsigned(_mm_movemask_epi8(hits)) ^ invert;
+      if(mask)
+        return b + first_bit(mask);
+    }
+    return find_of_scalar(b, e, set, matching);
+  }
+
+
+  // Candidates are positions where both first and last characters match,
+  // only they are compared in full
+  inline char const* find_substring_sse2(char const* b, char const* e,
+                                         std::string_view s) noexcept {
+    std::size_t const m = s.size();
+    __m128i const first = _mm_set1_epi8(s.front());
+    __m128i const last = _mm_set1_epi8(s.back());
+    for(; std::size_t(e - b) >= m - 1 + 16; b += 16) {
+      __m128i const head = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b));
+      __m128i const tail = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + m - 1));
+      unsigned mask = unsigned(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+      for(; mask; mask &= mask - 1) {
+        char const* const p = b + first_bit(mask);
+        if(std::memcmp(p + 1, s.data() + 1, m - 2) == 0)
+          return p;
+      }
+    }
+    return find_substring_scalar(b, e, s);
+  }
+
+#endif // UFORMAT_SEARCH_SSE2
+
+
+#if defined(UFORMAT_SEARCH_AVX2)
+
+  UFORMAT_TARGET_AVX2
+  inline char const* rfind_avx2(char const* b, char const* e, char c) noexcept {
+    __m256i const needle = _mm256_set1_epi8(c);
+    while(e - b >= 32) {
+      e -= 32;
+      __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(e));
+      unsigned const mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+      if(mask)
+        return e + last_bit(mask);
+    }
+    return rfind_sse2(b, e, c);
+  }
+
+
+  UFORMAT_TARGET_AVX2
+  inline char const* find_of_avx2(char const* b, char const* e,
+                                  std::string_view set, bool matching) noexcept {
+    __m256i needles[max_vector_charset];
+    for(std::size_t i = 0; i != set.size(); ++i)
+      needles[i] = _mm256_set1_epi8(set[i]);
+    unsigned const invert = matching ? 0u : 0xFFFFFFFFu;
+    for(; e - b >= 32; b += 32) {
+      __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b));
+      __m256i hits = _mm256_setzero_si256();
+      for(std::size_t i = 0; i != set.size(); ++i)
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, needles[i]));
+      unsigned const mask = unsigned(_mm256_movemask_epi8(hits)) ^ invert;
+      if(mask)
+        return b + first_bit(mask);
+    }
+    return find_of_sse2(b, e, set, matching);
+  }
+
+
+  UFORMAT_TARGET_AVX2
+  inline char const* find_substring_avx2(char const* b, char const* e,
+                                         std::string_view s) noexcept {
+    std::size_t const m = s.size();
+    __m256i const first = _mm256_set1_epi8(s.front());
+    __m256i const last = _mm256_set1_epi8(s.back());
+    for(; std::size_t(e - b) >= m - 1 + 32; b += 32) {
+      __m256i const head = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b));
+      __m256i const tail = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + m - 1));
+      unsigned mask = unsigned(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(head, first), _mm256_cmpeq_epi8(tail, last))));
+      for(; mask; mask &= mask - 1) {
+        char const* const p = b + first_bit(mask);
+        if(std::memcmp(p + 1, s.data() + 1, m - 2) == 0)
+          return p;
+      }
+    }
+    return find_substring_sse2(b, e, s);
+  }
+
+
+  inline bool has_avx2() noexcept {
+#if defined(__AVX2__)
+    return true;
+#else
+    static bool const supported = __builtin_cpu_supports("avx2");
+    return supported;
+#endif
+  }
+
+#endif // UFORMAT_SEARCH_AVX2
+
+
+  // libc memchr is already vectorized and dispatched by CPU
+  inline char const* find_char(char const* b, char const* e, char c) noexcept {
+    return static_cast<char const*>(std::memchr(b, c, static_cast<std::size_t>(e - b)));
+  }
+
+
+  inline char const* rfind_char(char const* b, char const* e, char c) noexcept {
+#if defined(UFORMAT_SEARCH_AVX2)
+    if(has_avx2())
+      return rfind_avx2(b, e, c);
+#endif
+#if defined(UFORMAT_SEARCH_SSE2)
+    return rfind_sse2(b, e, c);
+#else
+    return rfind_scalar(b, e, c);
+#endif
+  }
+
+
+  inline char const* find_of(char const* b, char const* e,
+                             std::string_view set, bool matching) noexcept {
+    if(set.size() == 1 && matching)
+      return find_char(b, e, set.front());
+#if defined(UFORMAT_SEARCH_SSE2)
+    if(set.size() <= max_vector_charset) {
+#if defined(UFORMAT_SEARCH_AVX2)
+      if(has_avx2())
+        return find_of_avx2(b, e, set, matching);
+#endif
+      return find_of_sse2(b, e, set, matching);
+    }
+#endif
+    return find_of_scalar(b, e, set, matching);
+  }
+
+
+  // s should not be empty
+  inline char const* find_substring(char const* b, char const* e,
+                                    std::string_view s) noexcept {
+    if(s.size() == 1)
+      return find_char(b, e, s.front());
+    if(std::size_t(e - b) < s.size())
+      return nullptr;
+#if defined(UFORMAT_SEARCH_AVX2)
+    if(has_avx2())
+      return find_substring_avx2(b, e, s);
+#endif
+#if defined(UFORMAT_SEARCH_SSE2)
+    return find_substring_sse2(b, e, s);
+#else
+    return find_substring_scalar(b, e, s);
+#endif
+  }
+
+} // detail
+
+
+} // uformat
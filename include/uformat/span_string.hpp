@@ -0,0 +1,191 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace uformat {
+
+
+  // Characters are written to memory owned by caller, e.g. slot of send ring;
+  // nothing is written past content, so it is not null terminated.
+  // Whatever does not fit is dropped whole and marks string as truncated
+  // until clear() or reset()
+  class span_string {
+  public:
+
+    using value_type = char;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = char*;
+    using const_pointer = char const*;
+    using reference = char&;
+    using const_reference = char const&;
+    using iterator = char*;
+    using const_iterator = char const*;
+
+    static constexpr size_type npos = size_type(-1);
+
+    span_string() noexcept = default;
+    span_string(char* data, size_type capacity) noexcept: data_{data}, capacity_{capacity} { }
+
+    template<std::size_t N>
+    explicit span_string(char (&data)[N]) noexcept: data_{data}, capacity_{N} { }
+
+
+    // Starts over on another region, e.g. next slot
+    void reset(char* data, size_type capacity) noexcept {
+      data_ = data;
+      size_ = 0;
+      capacity_ = capacity;
+      truncated_ = false;
+    }
+
+
+    char* begin() noexcept { return data_; }
+    char* end() noexcept { return data_ + size_; }
+    char const* begin() const noexcept { return data_; }
+    char const* end() const noexcept { return data_ + size_; }
+    char const* cbegin() const noexcept { return data_; }
+    char const* cend() const noexcept { return data_ + size_; }
+
+    char* data() noexcept { return data_; }
+    char const* data() const noexcept { return data_; }
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+    size_type size() const noexcept { return size_; }
+    size_type length() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    size_type max_size() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool truncated() const noexcept { return truncated_; }
+    void clear() noexcept { size_ = 0; truncated_ = false; }
+
+    // Region is fixed, there is nothing to reserve or give back
+    void reserve(size_type) const noexcept { }
+    void shrink_to_fit() const noexcept { }
+
+
+    // New characters are left as they are in region
+    bool resize(size_type n) noexcept {
+      if(n > capacity_)
+        return overflow();
+      size_ = n;
+      return true;
+    }
+
+
+    char& operator [] (size_type i) noexcept { return data_[i]; }
+    char const& operator [] (size_type i) const noexcept { return data_[i]; }
+
+    char& back() noexcept { return data_[size_ - 1]; }
+    char const& back() const noexcept { return data_[size_ - 1]; }
+    char& front() noexcept { return data_[0]; }
+    char const& front() const noexcept { return data_[0]; }
+
+
+    span_string& operator += (char c) noexcept {
+      push_back(c);
+      return *this;
+    }
+
+    span_string& operator += (char const* cc) noexcept { return append(cc); }
+    span_string& operator += (std::string const& rhs) noexcept { return append(rhs); }
+    span_string& operator += (std::string_view const& rhs) noexcept { return append(rhs); }
+
+    span_string& append(std::string const& rhs) noexcept {
+      return append(rhs.data(), rhs.size());
+    }
+
+    span_string& append(std::string_view const& rhs) noexcept {
+      return append(rhs.data(), rhs.size());
+    }
+
+    span_string& append(char const* cc) noexcept {
+      if(cc == nullptr)
+        return *this;
+      return append(cc, std::char_traits<char>::length(cc));
+    }
+
+    span_string& append(char const* b, char const* e) noexcept {
+      if(b == nullptr || e == nullptr)
+        return *this;
+      return append(b, size_type(e - b));
+    }
+
+
+    span_string& append(char const* cc, size_type n) noexcept {
+      if(n > capacity_ - size_) {
+        overflow();
+        return *this;
+      }
+      std::char_traits<char>::copy(data_ + size_, cc, n);
+      size_ += n;
+      return *this;
+    }
+
+
+    bool push_back(char c) noexcept {
+      if(size_ == capacity_)
+        return overflow();
+      data_[size_++] = c;
+      return true;
+    }
+
+
+    void pop_back() noexcept {
+      if(size_ != 0)
+        --size_;
+    }
+
+
+    std::string_view substr(size_type pos, size_type n) const noexcept {
+      return std::string_view{data_ + pos, n};
+    }
+
+
+    friend bool operator == (span_string const& x, std::string_view const& y) noexcept {
+      return x.view() == y;
+    }
+
+  private:
+
+    char* data_{nullptr};
+    size_type size_{0};
+    size_type capacity_{0};
+    bool truncated_{false};
+
+
+    bool overflow() noexcept {
+      truncated_ = true;
+      return false;
+    }
+
+  }; // span_string
+
+
+} // uformat
@@ -29,8 +29,21 @@
 #include <cmath>
 #include <mutex>
 #include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
 #include "fixed_string.hpp"
+#include "format_string.hpp"
+#include "floating.hpp"
 #include "continuous_string.hpp"
+#include "ring_string.hpp"
+#include "inline_string.hpp"
+#include "span_string.hpp"
+#include "rope_string.hpp"
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 
 namespace uformat {
@@ -42,6 +55,95 @@ namespace uformat {
 
 
 
+  namespace detail {
+
+    template<typename T>
+    using argument_type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+    // Argument types with an upper bound on printed size
+    template<typename T> struct is_bounded: std::bool_constant<
+      std::is_same_v<T, char> || std::is_same_v<T, bool>
+      || std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>
+      || std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>
+      || std::is_same_v<T, float> || std::is_same_v<T, double>
+      || std::is_same_v<T, char const*> || std::is_same_v<T, char*>
+      || std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>> { };
+
+    template<size_t N> struct is_bounded<char[N]>: std::true_type { };
+    template<size_t N> struct is_bounded<fixed_string<N>>: std::true_type { };
+
+
+    inline constexpr char digits_lut[200] = {
+      '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+      '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+      '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+      '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+      '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+      '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+      '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+      '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+      '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+      '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+    };
+
+
+    // x should not be zero
+    inline unsigned bit_width(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      return unsigned(64 - __builtin_clzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+      unsigned long i;
+      _BitScanReverse64(&i, x);
+      return unsigned(i + 1);
+#else
+      unsigned n = 0;
+      for(; x != 0; x >>= 1)
+        ++n;
+      return n;
+#endif
+    }
+
+
+    // 1233 / 4096 is slightly above log10(2), the table corrects the estimate
+    inline unsigned count_digits(uint64_t x) noexcept {
+      x |= 1;
+      unsigned const t = (bit_width(x) * 1233) >> 12;
+      return t + (x >= floating::pow10_integers[t]);
+    }
+
+
+#if defined(UFORMAT_SWAR_DIGITS)
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error UFORMAT_SWAR_DIGITS requires little-endian target
+#endif
+
+    // Opt-in replacement for digit pairs table in middle8 when caches are
+    // cold. Eight ASCII digits of n < 10^8 in one little-endian word:
+    // halves, quarters and single digits by multiply-shift in all lanes
+    inline uint64_t swar_digits8(uint32_t n) noexcept {
+      uint64_t const x = (n / 10000) | (uint64_t(n % 10000) << 32);
+      uint64_t const y = ((x * 10486) >> 20) & 0x0000007F0000007Full;
+      uint64_t const z = y | ((x - y * 100) << 16);
+      uint64_t const t = ((z * 103) >> 10) & 0x000F000F000F000Full;
+      return (t | ((z - t * 10) << 8)) + 0x3030303030303030ull;
+    }
+
+#endif
+
+
+    template<typename T>
+    std::make_unsigned_t<T> magnitude(T x) noexcept {
+      using unsigned_type = std::make_unsigned_t<T>;
+      if constexpr(std::is_signed_v<T>)
+        return x < 0 ? unsigned_type(unsigned_type(0) - unsigned_type(x)) : unsigned_type(x);
+      else
+        return x;
+    }
+
+  } // detail
+
+
   template<typename S>
   class texter {
   public:
@@ -57,11 +159,20 @@ namespace uformat {
     texter(texter&&) noexcept = default;
     texter& operator = (texter&&) noexcept = default;
 
+
+    // Arguments are passed to backend constructor
+    template<typename Arg, typename... Args, typename = std::enable_if_t<
+      !std::is_same_v<detail::argument_type<Arg>, texter> && std::is_constructible_v<S, Arg, Args...>>>
+    explicit texter(Arg&& arg, Args&&... args):
+      string_(std::forward<Arg>(arg), std::forward<Args>(args)...) { }
+
     S const& string() const noexcept { return string_; }
+    S& string() noexcept { return string_; }
     char const* data() const noexcept { return string_.data(); }
     size_type size() const noexcept { return string_.size(); }
     bool empty() const noexcept { return string_.empty(); }
     void clear() noexcept { string_.clear(); }
+    void shrink_to_fit() { string_.shrink_to_fit(); }
 
 
     size_type capacity() const noexcept {
@@ -94,7 +205,6 @@ namespace uformat {
       size_type allocated;
       char* buffer = allocate(n, allocated);
       if (!buffer) return *this;
-      char* p = buffer;
       for (char* p = buffer; p != buffer + n; ++p)
         *p = c;
       return shrink(allocated - n);
@@ -122,13 +232,7 @@ namespace uformat {
     texter& left(size_type width, Arg&& arg) {
       size_type const previous_size = string_.size();
       (*this) << arg;
-      size_type const next_size = string_.size();
-      size_type const n = next_size - previous_size;
-      if (n >= width)
-        return *this;
-      size_type const spaces_count = width - n;
-      char_n(' ', spaces_count);
-      return *this;
+      return justify(previous_size, width, alignment::left, ' ');
     }
 
 
@@ -136,29 +240,32 @@ namespace uformat {
     texter& right(size_type width, Arg&& arg) {
       size_type const previous_size = string_.size();
       (*this) << arg;
-      size_type const next_size = string_.size();
-      size_type const n = next_size - previous_size;
-      if (n >= width)
-        return *this;
-      size_type const spaces_count = width - n;
-      char_n(' ', spaces_count);
-      for (size_type i = next_size - 1; i != previous_size - 1; --i)
-        string_[i + spaces_count] = string_[i];
-      for (size_type i = 0; i != spaces_count; ++i)
-        string_[previous_size + i] = ' ';
-      return *this;
+      return justify(previous_size, width, alignment::right, ' ');
     }
 
 
-    texter& print() {
-      return *this;
+    // Reserves once for the whole pack when every argument has a known
+    // size bound, prints argument by argument otherwise or when the bound
+    // exceeds what backend can hold
+    template<typename... Args>
+    texter& print(Args&&... args) {
+      if constexpr(sizeof...(Args) != 0
+                   && (detail::is_bounded<detail::argument_type<Args>>::value && ...)) {
+        return print_bounded(measured(std::forward<Args>(args))...);
+      } else {
+        (((*this) << args), ...);
+        return *this;
+      }
     }
 
 
-    template<typename Arg, typename... Args>
-    texter& print(Arg&& arg, Args&&... args) {
-      (*this) << arg;
-      print(std::forward<Args>(args)...);
+    template<format_string F, typename... Args>
+    texter& format(Args&&... args) {
+      constexpr auto const& parsed = detail::formatting::parsed<F>;
+      static_assert(parsed.arguments_count == sizeof...(Args),
+                    "format string and arguments count mismatch");
+      format_segments<F>(std::make_index_sequence<parsed.segments_count>{},
+                         std::forward_as_tuple(std::forward<Args>(args)...));
       return *this;
     }
 
@@ -173,6 +280,16 @@ namespace uformat {
     }
 
 
+    texter& shortest(double x) {
+      return print_shortest_float(x);
+    }
+
+
+    texter& shortest(float x) {
+      return print_shortest_float(x);
+    }
+
+
     texter& fixed(uint32_t x, unsigned width) {
       constexpr auto digits = 10;
       return print_fixed_int<digits>(x, width);
@@ -289,26 +406,22 @@ namespace uformat {
 
 
     friend texter& operator << (texter& p, uint32_t x) {
-      constexpr auto digits = 10;
-      return p.print_int<digits>(x);
+      return p.print_int(x);
     }
 
 
     friend texter& operator << (texter& p, int32_t x) {
-      constexpr auto digits = 11;
-      return p.print_int<digits>(x);
+      return p.print_int(x);
     }
 
 
     friend texter& operator << (texter& p, uint64_t x) {
-      constexpr auto digits = 18;
-      return p.print_int<digits>(x);
+      return p.print_int(x);
     }
 
 
     friend texter& operator << (texter& p, int64_t x) {
-      constexpr auto digits = 19;
-      return p.print_int<digits>(x);
+      return p.print_int(x);
     }
 
 
@@ -349,6 +462,64 @@ namespace uformat {
     }
 
 
+    texter& justify(size_type from, size_type width, alignment alignment, char c) {
+      size_type const next_size = string_.size();
+      size_type const n = next_size - from;
+      if (n >= width)
+        return *this;
+      size_type const count = width - n;
+      char_n(c, count);
+      if (string_.size() != next_size + count || alignment == alignment::left)
+        return *this;
+      for (size_type i = next_size - 1; i != from - 1; --i)
+        string_[i + count] = string_[i];
+      for (size_type i = 0; i != count; ++i)
+        string_[from + i] = c;
+      return *this;
+    }
+
+
+    template<auto F, size_t... I, typename Tuple>
+    void format_segments(std::index_sequence<I...>, Tuple&& args) {
+      (format_segment<F, I>(args), ...);
+    }
+
+
+    template<auto F, size_t I, typename Tuple>
+    void format_segment(Tuple& args) {
+      constexpr auto const& parsed = detail::formatting::parsed<F>;
+      constexpr auto const& segment = parsed.segments[I];
+      if constexpr(segment.literal) {
+        string_.append(parsed.text + segment.offset, segment.size);
+      } else {
+        auto const& arg = std::get<segment.argument>(args);
+        using arg_type = std::decay_t<decltype(arg)>;
+        size_type const previous_size = string_.size();
+        if constexpr(segment.precision >= 0) {
+          static_assert(std::is_floating_point_v<arg_type>,
+                        "precision is applicable to floating point arguments only");
+          fixed(arg, unsigned(segment.precision));
+        } else {
+          (*this) << arg;
+        }
+        if constexpr(segment.width == 0) {
+          return;
+        } else if constexpr(segment.zero) {
+          size_type const from = previous_size
+            + (string_.size() != previous_size && string_[previous_size] == '-');
+          justify(from, segment.width - (from - previous_size), alignment::right, '0');
+        } else {
+          constexpr bool numeric = std::is_arithmetic_v<arg_type>
+            && !std::is_same_v<arg_type, char> && !std::is_same_v<arg_type, bool>;
+          constexpr auto align = segment.align == '<' ? alignment::left
+            : segment.align == '>' ? alignment::right
+            : numeric ? alignment::right : alignment::left;
+          justify(previous_size, segment.width, align, ' ');
+        }
+      }
+    }
+
+
     void format_other_attributes()
     { }
 
@@ -443,20 +614,136 @@ namespace uformat {
     }
 
 
-    char* allocate(size_type n, size_type& m) {
+    static constexpr size_type size_bound(char) noexcept { return 1; }
+    static constexpr size_type size_bound(bool) noexcept { return 5; }
+    static constexpr size_type size_bound(uint32_t) noexcept { return 10; }
+    static constexpr size_type size_bound(int32_t) noexcept { return 11; }
+    static constexpr size_type size_bound(uint64_t) noexcept { return 20; }
+    static constexpr size_type size_bound(int64_t) noexcept { return 20; }
 
-      size_type const old_size = string_.size();
-      size_type new_size = old_size + n;
+    static size_type size_bound(char const* cc) noexcept {
+      return cc ? std::strlen(cc) : 0;
+    }
+
+    static size_type size_bound(std::string_view const& sv) noexcept { return sv.size(); }
+    static size_type size_bound(std::string const& s) noexcept { return s.size(); }
 
-      if(new_size > string_.capacity()) {
-        new_size = nearest_power_of_2(new_size);
-        m = size_type(new_size - old_size);
+    template<size_t N>
+    static size_type size_bound(fixed_string<N> const& s) noexcept { return s.size(); }
+
+    template<typename T>
+    static std::enable_if_t<std::is_floating_point_v<T>, size_type> size_bound(T x) noexcept {
+      return std::fabs(double(x)) >= detail::floating::exact_integer_limit ? 330 : 38;
+    }
+
+
+    static void write(char c, char*& p) noexcept { *p++ = c; }
+
+    static void write(bool x, char*& p) noexcept {
+      if(x) {
+        std::memcpy(p, "true", 4);
+        p += 4;
+      } else {
+        std::memcpy(p, "false", 5);
+        p += 5;
       }
-      else {
-        m = n;
+    }
+
+    static void write(uint32_t x, char*& p) noexcept { convert(x, p); }
+    static void write(int32_t x, char*& p) noexcept { convert(x, p); }
+    static void write(uint64_t x, char*& p) noexcept { convert(x, p); }
+    static void write(int64_t x, char*& p) noexcept { convert(x, p); }
+
+    static void write(char const* cc, char*& p) noexcept {
+      write(std::string_view{cc, size_bound(cc)}, p);
+    }
+
+    static void write(std::string_view const& sv, char*& p) noexcept {
+      if(sv.empty())
+        return;
+      std::memcpy(p, sv.data(), sv.size());
+      p += sv.size();
+    }
+
+    static void write(std::string const& s, char*& p) noexcept {
+      write(std::string_view{s.data(), s.size()}, p);
+    }
+
+    template<size_t N>
+    static void write(fixed_string<N> const& s, char*& p) noexcept {
+      write(std::string_view{s.data(), s.size()}, p);
+    }
+
+    template<typename T>
+    static std::enable_if_t<std::is_floating_point_v<T>> write(T x, char*& p) noexcept {
+      convert(double(x), p, default_precision);
+    }
+
+
+    template<typename... Args>
+    texter& print_bounded(Args&&... args) {
+      size_type const n = (argument_bound(std::forward<Args>(args)) + ...);
+      if(n <= string_.max_size() - string_.size()) {
+        size_type allocated;
+        char* buffer = allocate(n, allocated);
+        if(buffer) {
+          char* p = buffer;
+          (write_argument(std::forward<Args>(args), p), ...);
+          return shrink(allocated - size_type(p - buffer));
+        }
       }
+      (((*this) << args), ...);
+      return *this;
+    }
 
-      string_.resize(new_size);
+
+    // C strings are measured once here, both bound and write take the view
+    template<typename Arg>
+    static decltype(auto) measured(Arg&& arg) noexcept {
+      using type = std::remove_reference_t<Arg>;
+      if constexpr(std::is_same_v<detail::argument_type<Arg>, char const*>
+                   || std::is_same_v<detail::argument_type<Arg>, char*>
+                   || (std::is_array_v<type> && !std::is_const_v<type>))
+        return std::string_view{arg, size_bound(arg)};
+      else
+        return std::forward<Arg>(arg);
+    }
+
+
+    // Constant character arrays are taken as literals of N - 1 characters
+    template<typename Arg>
+    static size_type argument_bound(Arg&& arg) noexcept {
+      using type = std::remove_reference_t<Arg>;
+      if constexpr(std::is_array_v<type> && std::is_const_v<type>)
+        return std::extent_v<type> - 1;
+      else
+        return size_bound(arg);
+    }
+
+
+    template<typename Arg>
+    static void write_argument(Arg&& arg, char*& p) noexcept {
+      using type = std::remove_reference_t<Arg>;
+      if constexpr(std::is_array_v<type> && std::is_const_v<type>) {
+        std::memcpy(p, arg, std::extent_v<type> - 1);
+        p += std::extent_v<type> - 1;
+      } else {
+        write(arg, p);
+      }
+    }
+
+
+    // Grows capacity to a power of 2 but size exactly by n
+    char* allocate(size_type n, size_type& m) {
+
+      size_type const old_size = string_.size();
+      size_type const new_size = old_size + n;
+
+      if(new_size > string_.capacity())
+        reserve(new_size);
+
+      grow(new_size);
+      m = n;
 
       if(string_.size() != new_size)
         return nullptr;
@@ -466,66 +753,179 @@ namespace uformat {
 
 
     texter& shrink(size_type n) {
-      string_.resize(string_.size() - n);
+      if(n != 0)
+        string_.resize(string_.size() - n);
       return *this;
     }
 
 
-    template<unsigned N, typename T> texter& print_int(T x) {
-      size_type digits;
-      char* buffer = allocate(N, digits);
+    // Allocated characters are overwritten right away, so std::string
+    // skips zero filling them when the library allows
+    void grow(size_type n) {
+#if defined(__cpp_lib_string_resize_and_overwrite)
+      if constexpr(std::is_same_v<S, std::string>)
+        string_.resize_and_overwrite(n, [](char*, size_type k) noexcept { return k; });
+      else
+        string_.resize(n);
+#else
+      string_.resize(n);
+#endif
+    }
+
+
+    template<typename T> texter& print_int(T x) {
+      auto const u = detail::magnitude(x);
+      size_type const n = size_type(x < 0) + detail::count_digits(u);
+      size_type allocated;
+      char* buffer = allocate(n, allocated);
       if(!buffer) return *this;
-      char* p = buffer;
-      convert(x, p);
-      shrink(digits - (p - buffer));
+      if(x < 0)
+        *buffer = '-';
+      convert_backward(u, buffer + n);
       return *this;
     }
 
 
+    // Width includes sign, leading zeros go after it
     template<unsigned N, typename T> texter& print_fixed_int(T x, unsigned width) {
       if(width > N)
         width = N;
-      size_type digits;
-      char* buffer = allocate(width, digits);
+      auto const u = detail::magnitude(x);
+      unsigned const digits = detail::count_digits(u);
+      unsigned const sign = x < 0;
+      size_type const n = digits + sign > width ? digits + sign : width;
+      size_type allocated;
+      char* buffer = allocate(n, allocated);
       if(!buffer) return *this;
-      char* p = buffer;
-      convert(x, p);
-      unsigned const actual_width = unsigned(p - buffer);
-      if(actual_width >= width)
-        return shrink(digits - actual_width);
-      unsigned const leadings_count = width - actual_width;
-      for(p = buffer + actual_width - 1; p != buffer + leadings_count - 1; --p)
-        p[leadings_count] = p[0];
-      for(; p != buffer - 1; --p) {
-        p[leadings_count] = p[0];
-        p[0] = '0';
-      }
-      shrink(digits - width);
+      if(sign)
+        *buffer = '-';
+      for(char* p = buffer + sign; p != buffer + n - digits; ++p)
+        *p = '0';
+      convert_backward(u, buffer + n);
       return *this;
     }
 
 
+    // Value is split into parts first, so exactly its length is allocated
     template<typename T> texter& print_fixed_float(T x, unsigned precision) {
-      size_type digits;
-      char* buffer = allocate(38, digits);
-      if(!buffer) return *this;
-      char* p = buffer;
-      convert(double(x), p, precision);
-      return shrink(digits - (p - buffer));
+      using namespace detail::floating;
+      if(precision > 16)
+        precision = 16;
+      double value = double(x);
+      size_type const sign = size_type(value < 0.0);
+      size_type allocated;
+      if(!std::isfinite(value)) {
+        char* p = allocate(sign + 3, allocated);
+        if(p)
+          convert(value, p, precision);
+        return *this;
+      }
+      value = std::fabs(value);
+      size_type const fraction_length = precision == 0 ? 0 : precision + 1;
+      if(!(value < exact_integer_limit)) {
+        big_decimal const integer{decompose(value)};
+        size_type const integer_length = detail::count_digits(integer.limbs[integer.count - 1])
+          + 8 * size_type(integer.count - 1);
+        char* p = allocate(sign + integer_length + fraction_length, allocated);
+        if(!p) return *this;
+        if(sign)
+          *p++ = '-';
+        convert(integer, p, precision);
+        return *this;
+      }
+      fixed_parts const parts = split_fixed(value, precision);
+      char* p = allocate(sign + detail::count_digits(parts.integer) + fraction_length, allocated);
+      if(!p) return *this;
+      if(sign)
+        *p++ = '-';
+      convert(parts, p, precision);
+      return *this;
     }
 
 
-    static void convert(double x, char*& p, unsigned precision) {
-      static double pow10[18] = {
-        1E0, 1E1, 1E2, 1E3, 1E4, 1E5, 1E6, 1E7, 1E8, 1E9, 1E10, 1E11, 1E12, 1E13,
-        1E14, 1E15, 1E16, 1E17
-      };
-      if(precision > 16)
-        precision = 16;
+    // Formatted on stack, so backend is asked for exact length only
+    template<typename T> texter& print_shortest_float(T x) {
+      char scratch[40];
+      char* p = scratch;
+      convert_shortest(x, p);
+      size_type const n = size_type(p - scratch);
+      size_type allocated;
+      char* buffer = allocate(n, allocated);
+      if(buffer)
+        std::memcpy(buffer, scratch, n);
+      return *this;
+    }
+
+
+    template<typename T> static void convert_shortest(T x, char*& p) {
+      if(std::isnan(x)) {
+        *p++ = 'N'; *p++ = 'a'; *p++ = 'N';
+        return;
+      }
+      if(std::signbit(x)) {
+        *p++ = '-';
+        x = -x;
+      }
       if(std::isinf(x)) {
         *p++ = 'I'; *p++ = 'N'; *p++ = 'F';
         return;
       }
+      auto const shortest = detail::floating::shortest(x);
+      if(shortest.significand == 0) {
+        *p++ = '0';
+        return;
+      }
+      detail::floating::decimal<uint64_t> decimal{shortest.significand, shortest.exponent};
+      detail::floating::remove_trailing_zeros(decimal);
+      convert(decimal, p);
+    }
+
+
+    // Fixed notation when the decimal point is within [-5, 21] digits,
+    // scientific notation otherwise. Needs 40 bytes at p
+    static void convert(detail::floating::decimal<uint64_t> const& decimal, char*& p) {
+      char* const b = p;
+      convert(decimal.significand, p);
+      int const n = int(p - b);
+      int const point = n + decimal.exponent;
+      if(decimal.exponent >= 0 && point <= 21) {
+        for(int e = decimal.exponent; e != 0; --e)
+          *p++ = '0';
+      } else if(point > 0 && point <= 21) {
+        std::memmove(b + point + 1, b + point, size_t(n - point));
+        b[point] = '.';
+        ++p;
+      } else if(point > -6 && point <= 0) {
+        int const leadings_count = 2 - point;
+        std::memmove(b + leadings_count, b, size_t(n));
+        for(char* q = b; q != b + leadings_count; ++q)
+          *q = '0';
+        b[1] = '.';
+        p += leadings_count;
+      } else {
+        if(n > 1) {
+          std::memmove(b + 2, b + 1, size_t(n - 1));
+          b[1] = '.';
+          ++p;
+        }
+        *p++ = 'e';
+        int exponent = point - 1;
+        if(exponent < 0) {
+          *p++ = '-';
+          exponent = -exponent;
+        } else {
+          *p++ = '+';
+        }
+        convert(uint32_t(exponent), p);
+      }
+    }
+
+
+    // Needs 38 bytes at p for |x| < 2^53, 330 bytes otherwise
+    static void convert(double x, char*& p, unsigned precision) {
+      using namespace detail::floating;
+      if(precision > 16)
+        precision = 16;
       if(std::isnan(x)) {
         *p++ = 'N'; *p++ = 'a'; *p++ = 'N';
         return;
@@ -534,61 +934,127 @@ namespace uformat {
         *p++ = '-';
         x = -x;
       }
-      
-      uint64_t integer = uint64_t(x);
-      convert(integer, p);
-      *p++ = '.';
-      x -= double(integer);
-      x *= pow10[precision];
-      x += 0.5;
-      convert(uint64_t(x), p);
+      if(std::isinf(x)) {
+        *p++ = 'I'; *p++ = 'N'; *p++ = 'F';
+        return;
+      }
+
+      if(!(x < exact_integer_limit))
+        convert(big_decimal{decompose(x)}, p, precision);
+      else
+        convert(split_fixed(x, precision), p, precision);
     }
 
 
-    static void convert(uint32_t x, char*& p) {
-      if(x < 100000000) {
-        if(x == 0)
-          *p++ = '0';
-        else
-          begin8(p, x);
+    // Integer part of |x| < 2^53 with carry from rounding and fraction
+    // scaled to precision digits
+    struct fixed_parts {
+      uint64_t integer;
+      uint64_t fraction;
+    };
+
+
+    static fixed_parts split_fixed(double x, unsigned precision) noexcept {
+      using namespace detail::floating;
+      uint64_t const scale = pow10_integers[precision];
+      uint64_t integer = uint64_t(int64_t(x));
+      double const rest = (x - double(integer)) * 9223372036854775808.0;
+      int64_t const bits = int64_t(rest);
+      uint64_t fraction;
+      if(double(bits) == rest) {
+        fraction = scale_fraction(integer, uint64_t(bits), 63, scale);
       } else {
-        begin2(p, x / 100000000);
-        middle8(p, x % 100000000);
+        binary const b = decompose(x);
+        fraction = scale_fraction(integer, b.significand, -b.exponent, scale);
       }
+      if(fraction == scale) {
+        ++integer;
+        fraction = 0;
+      }
+      return {integer, fraction};
+    }
+
+
+    static void convert(fixed_parts const& parts, char*& p, unsigned precision) {
+      using namespace detail::floating;
+      convert(parts.integer, p);
+      if(precision == 0)
+        return;
+      *p++ = '.';
+      char* const e = p + precision;
+      if(precision <= 8)
+        middle8(p, uint32_t(parts.fraction * pow10_integers[8 - precision]));
+      else
+        middle16(p, parts.fraction * pow10_integers[16 - precision]);
+      p = e;
+    }
+
+
+    // Integers beyond 2^53 have no fraction, it is filled with zeros
+    static void convert(detail::floating::big_decimal const& integer, char*& p, unsigned precision) {
+      begin8(p, integer.limbs[integer.count - 1]);
+      for(int i = integer.count - 2; i >= 0; --i)
+        middle8(p, integer.limbs[i]);
+      if(precision == 0)
+        return;
+      *p++ = '.';
+      for(unsigned i = 0; i != precision; ++i)
+        *p++ = '0';
+    }
+
+
+    static void convert(uint32_t x, char*& p) {
+      p += detail::count_digits(x);
+      convert_backward(x, p);
     }
 
 
     static void convert(int32_t x, char*& p) {
-      if(x < 0) {
+      if(x < 0)
         *p++ = '-';
-        x = -x;
-      }
-      convert(uint32_t(x), p);
+      convert(detail::magnitude(x), p);
     }
 
 
     static void convert(uint64_t x, char*& p) {
-      if(x < 100000000) {
-        if(x == 0)
-          *p++ = '0';
-        else
-          begin8(p, uint32_t(x));
-      } else if(x < 10000000000000000) {
-        begin8(p, uint32_t(x / 100000000));
-        middle8(p, x % 100000000);
-      } else {
-        begin4(p, uint32_t(x / 10000000000000000));
-        middle16(p, x % 10000000000000000);
-      }
+      p += detail::count_digits(x);
+      convert_backward(x, p);
     }
 
 
     static void convert(int64_t x, char*& p) {
-      if(x < 0) {
+      if(x < 0)
         *p++ = '-';
-        x = -x;
+      convert(detail::magnitude(x), p);
+    }
+
+
+    // Writes digits of x backward, ending just before e
+    static void convert_backward(uint32_t x, char* e) {
+      while(x >= 100) {
+        uint32_t const q = x / 100;
+        e -= 2;
+        std::memcpy(e, &detail::digits_lut[(x - q * 100) * 2], 2);
+        x = q;
+      }
+      if(x < 10) {
+        *--e = char('0' + x);
+      } else {
+        e -= 2;
+        std::memcpy(e, &detail::digits_lut[x * 2], 2);
+      }
+    }
+
+
+    static void convert_backward(uint64_t x, char* e) {
+      while(x >= 100000000) {
+        uint64_t const q = x / 100000000;
+        e -= 8;
+        char* p = e;
+        middle8(p, uint32_t(x - q * 100000000));
+        x = q;
       }
-      convert(uint64_t(x), p);
+      convert_backward(uint32_t(x), e);
     }
 
 
@@ -601,21 +1067,8 @@ namespace uformat {
 
 
     static void middle2(char*& p, uint32_t n) {
-      static char const digits_lut[200] = {
-        '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
-        '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
-        '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
-        '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
-        '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
-        '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
-        '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
-        '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
-        '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
-        '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
-      };
-      uint32_t const t = n * 2;
-      *p++ = digits_lut[t];
-      *p++ = digits_lut[t + 1];
+      std::memcpy(p, &detail::digits_lut[n * 2], 2);
+      p += 2;
     }
 
 
@@ -646,8 +1099,14 @@ namespace uformat {
 
 
     static void middle8(char*& p, uint32_t n) {
+#if defined(UFORMAT_SWAR_DIGITS)
+      uint64_t const digits = detail::swar_digits8(n);
+      std::memcpy(p, &digits, 8);
+      p += 8;
+#else
       middle4(p, n / 10000);
       middle4(p, n % 10000);
+#endif
     }
 
 
@@ -666,6 +1125,10 @@ namespace uformat {
   using dpage_texter = texter<dpage_string>;
   using large_texter = texter<large_string>;
   using continuous_texter = texter<continuous_string<>>;
+  using ring_texter = texter<ring_string<>>;
+  using inline_texter = texter<inline_string<>>;
+  using span_texter = texter<span_string>;
+  using rope_texter = texter<rope_string<>>;
 
 
 } // uformat
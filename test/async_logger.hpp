@@ -0,0 +1,116 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include <uformat/async_logger.hpp>
+
+
+namespace {
+
+  struct throwing { };
+
+  template<typename S>
+  uformat::texter<S>& operator << (uformat::texter<S>&, throwing) {
+    throw std::runtime_error{"formatting failed"};
+  }
+
+
+  std::vector<std::string> read_lines(std::FILE* file) {
+    std::vector<std::string> lines;
+    std::rewind(file);
+    char buffer[256];
+    while(std::fgets(buffer, sizeof(buffer), file))
+      lines.emplace_back(buffer);
+    return lines;
+  }
+
+}
+
+
+TEST_CASE("async_logger::print") {
+  std::FILE* file = std::tmpfile();
+  REQUIRE(file != nullptr);
+  {
+    uformat::async_logger target{uformat::overflow::block, 16, file, file};
+    std::vector<std::thread> producers;
+    for(int i = 0; i != 4; ++i)
+      producers.emplace_back([&target, i] {
+        for(int j = 0; j != 1000; ++j)
+          target.print("producer ", i, " line ", j);
+      });
+    for(auto& producer: producers)
+      producer.join();
+    target.error("done");
+  }
+  auto const lines = read_lines(file);
+  std::fclose(file);
+  REQUIRE(lines.size() == 4001);
+  REQUIRE(lines.back() == "done\n");
+  size_t complete = 0;
+  for(auto const& line: lines)
+    complete += line.compare(0, 9, "producer ") == 0 && line.back() == '\n';
+  REQUIRE(complete == 4000);
+}
+
+
+TEST_CASE("async_logger::dropped") {
+  std::FILE* file = std::tmpfile();
+  REQUIRE(file != nullptr);
+  int written = 0;
+  uint64_t dropped = 0;
+  {
+    uformat::async_logger target{uformat::overflow::drop_and_count, 2, file, file};
+    for(int i = 0; i != 10000; ++i)
+      written += target.print("line ", i);
+    dropped = target.dropped();
+  }
+  auto const lines = read_lines(file);
+  std::fclose(file);
+  REQUIRE(written + dropped == 10000);
+  REQUIRE(lines.size() == size_t(written));
+}
+
+
+TEST_CASE("async_logger::print throwing") {
+  std::FILE* file = std::tmpfile();
+  REQUIRE(file != nullptr);
+  {
+    uformat::async_logger target{uformat::overflow::block, 4, file, file};
+    for(int i = 0; i != 100; ++i) {
+      REQUIRE(target.print("line ", i));
+      REQUIRE_THROWS(target.print("bad ", throwing{}));
+    }
+  }
+  auto const lines = read_lines(file);
+  std::fclose(file);
+  REQUIRE(lines.size() == 100);
+  REQUIRE(lines.back() == "line 99\n");
+}
@@ -25,6 +25,9 @@
 
 #include <doctest/doctest.h>
 #include <uformat/continuous_string.hpp>
+#include <uformat/texter.hpp>
+#include <cstdio>
+#include <filesystem>
 
 
 TEST_CASE("continuous_string::continuous_string") {
@@ -42,4 +45,186 @@ TEST_CASE("continuous_string(\"test\")") {
   REQUIRE(target.length() == sizeof("test") - 1);
   REQUIRE(target == "test");
   REQUIRE(strcmp(target.data(), "test") == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("continuous_string::find") {
+  uformat::continuous_string<1048576> target;
+  std::string expected;
+  for(int i = 0; i != 1000; ++i)
+    expected += "field" + std::to_string(i) + (i % 7 == 0 ? "\t" : ",");
+  target.append(expected);
+  for(auto const* s: {"field999", "field7\t", "d13,", "\tfield8", "missing"})
+    REQUIRE(target.find(s) == expected.find(s));
+  REQUIRE(target.rfind('\t') == expected.rfind('\t'));
+  REQUIRE(target.find_first_of("\t;", 100) == expected.find_first_of("\t;", 100));
+  REQUIRE(target.find_first_not_of("field0123456789,", 0) ==
+          expected.find_first_not_of("field0123456789,", 0));
+  REQUIRE(target.find_first_not_of("field0123456789,\t") == target.npos);
+}
+
+
+TEST_CASE("continuous_string::append grows in place") {
+  uformat::continuous_string<1048576> target;
+  char const* const data = target.data();
+  std::string const chunk(1000, 'x');
+  for(int i = 0; i != 1000; ++i)
+    target.append(chunk);
+  REQUIRE(target.size() == 1000000);
+  REQUIRE(target.data() == data);
+  REQUIRE(target[999999] == 'x');
+  REQUIRE(target.data()[target.size()] == '\0');
+}
+
+TEST_CASE("continuous_string::page_policy") {
+  uformat::continuous_string<16777216, uformat::page_policy::transparent_huge, 4194304> huge;
+  REQUIRE(reinterpret_cast<std::uintptr_t>(huge.data()) % 2097152 == 0);
+  huge.append(std::string(5000000, 'y'));
+  REQUIRE(huge.size() == 5000000);
+  REQUIRE(huge[4999999] == 'y');
+  uformat::continuous_string<16777216, uformat::page_policy::explicit_huge> fallback("test");
+  REQUIRE(fallback == "test");
+  uformat::continuous_string<65536, uformat::page_policy::transparent_huge> small;
+  REQUIRE(small.valid());
+  REQUIRE(small.capacity() == 2097151);
+  small.append(std::string(100000, 'z'));
+  REQUIRE(small.size() == 100000);
+  uformat::continuous_string<4096, uformat::page_policy::explicit_huge> tiny("test");
+  REQUIRE(tiny == "test");
+}
+
+TEST_CASE("continuous_string::shrink_to_fit") {
+  uformat::continuous_string<16777216> target;
+  auto const initial = target.committed();
+  target.append(std::string(3000000, 'z'));
+  REQUIRE(target.committed() >= 3000000);
+  target.resize(10);
+  target.shrink_to_fit();
+  REQUIRE(target.committed() == initial);
+  REQUIRE(target == "zzzzzzzzzz");
+  target.append(std::string(100000, 'z'));
+  REQUIRE(target.size() == 100010);
+
+  uformat::continuous_string<16777216, uformat::page_policy::standard, 0, 4> automatic;
+  automatic.append(std::string(3000000, 'z'));
+  for(int i = 0; i != 4; ++i) {
+    auto const committed = automatic.committed();
+    automatic.clear();
+    REQUIRE(automatic.committed() == committed);
+    automatic.append("small");
+  }
+  for(int i = 0; i != 4; ++i) {
+    automatic.clear();
+    automatic.append("small");
+  }
+  REQUIRE(automatic.committed() == initial);
+}
+
+#if !defined(_WIN32)
+
+TEST_CASE("continuous_string::mapped_file") {
+  auto const path = (std::filesystem::temp_directory_path() / "uformat_mapped_file.csv").string();
+  {
+    uformat::continuous_texter csv{uformat::mapped_file{path.c_str()}};
+    REQUIRE(csv.string().mapped());
+    for(int i = 0; i != 100000; ++i)
+      csv.print(i, ',', i * 2, '\n');
+    REQUIRE(csv.string().sync());
+  }
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  REQUIRE(file != nullptr);
+  std::string content(1 << 21, '\0');
+  content.resize(std::fread(content.data(), 1, content.size(), file));
+  std::fclose(file);
+  std::remove(path.c_str());
+  REQUIRE(content.size() == 1233335);
+  REQUIRE(content.compare(0, 8, "0,0\n1,2\n") == 0);
+  REQUIRE(content.compare(content.size() - 13, 13, "99999,199998\n") == 0);
+}
+
+
+TEST_CASE("continuous_string::mapped_file can't be opened") {
+  uformat::continuous_texter csv{uformat::mapped_file{"/nonexistent/uformat/export.csv"}};
+  REQUIRE(!csv.string().valid());
+  REQUIRE(!csv.string().mapped());
+  csv.print(1500, ',', 1.25, '\n');
+  csv << "order" << 'x' << std::string("long");
+  csv.string().assign("text");
+  csv.string() += "more";
+  csv.clear();
+  REQUIRE(csv.empty());
+  REQUIRE(csv.data() == nullptr);
+}
+
+
+TEST_CASE("continuous_string::shared_memory") {
+  std::string const name = "/uformat_test_" + std::to_string(getpid());
+  uformat::continuous_texter writer{uformat::shared_memory{name.c_str()}};
+  REQUIRE(writer.string().mapped());
+  uformat::shared_view reader{name.c_str()};
+  REQUIRE(bool(reader));
+  REQUIRE(reader.view().empty());
+  for(int i = 0; i != 100000; ++i)
+    writer.print("line ", i, '\n');
+  REQUIRE(reader.view().empty());
+  writer.string().publish();
+  REQUIRE(reader.view().size() == writer.size());
+  REQUIRE(reader.view().substr(reader.view().size() - 11) == "line 99999\n");
+  auto const epoch = reader.epoch();
+  writer.clear();
+  REQUIRE(reader.epoch() != epoch);
+  REQUIRE(reader.view().empty());
+}
+
+
+TEST_CASE("continuous_string::shared_memory read after clear") {
+  std::string const name = "/uformat_seqlock_" + std::to_string(getpid());
+  uformat::continuous_texter writer{uformat::shared_memory{name.c_str()}};
+  REQUIRE(writer.string().valid());
+  uformat::shared_view reader{name.c_str()};
+  REQUIRE(bool(reader));
+  writer.print("order ", 1500, '\n');
+  writer.string().publish();
+  std::string content;
+  REQUIRE(reader.read(content));
+  REQUIRE(content == "order 1500\n");
+  auto const epoch = reader.epoch();
+  auto const view = reader.view();
+  REQUIRE(reader.unchanged(epoch));
+  writer.clear();
+  writer.print("trade ", 2500, '\n');
+  writer.string().publish();
+  REQUIRE(view == "trade 2500\n"); // overwritten in place
+  REQUIRE(!reader.unchanged(epoch));
+  REQUIRE(reader.read(content));
+  REQUIRE(content == "trade 2500\n");
+  auto const next = reader.epoch();
+  writer.string().pop_back();
+  REQUIRE(!reader.unchanged(next));
+  REQUIRE(reader.read(content));
+  REQUIRE(content == "trade 2500");
+}
+
+
+TEST_CASE("continuous_string::shared_memory has single writer") {
+  std::string const name = "/uformat_owner_" + std::to_string(getpid());
+  uformat::continuous_texter writer{uformat::shared_memory{name.c_str()}};
+  REQUIRE(writer.string().valid());
+  writer.print("line ", 1, '\n');
+  writer.string().publish();
+  {
+    uformat::continuous_texter second{uformat::shared_memory{name.c_str()}};
+    REQUIRE(!second.string().valid());
+    second.print("clobbered\n");
+    REQUIRE(second.empty());
+  }
+  uformat::shared_view reader{name.c_str()};
+  REQUIRE(bool(reader));
+  REQUIRE(reader.view() == "line 1\n");
+  std::string const long_name = "/" + std::string(300, 'x');
+  uformat::continuous_texter unnamed{uformat::shared_memory{long_name.c_str()}};
+  REQUIRE(!unnamed.string().valid());
+  unnamed.print("line ", 2, '\n');
+  REQUIRE(unnamed.empty());
+}
+
+#endif
@@ -0,0 +1,88 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include <uformat/deferred_logger.hpp>
+
+
+TEST_CASE("deferred_logger::print") {
+  std::FILE* file = std::tmpfile();
+  REQUIRE(file != nullptr);
+  std::string const name{"qty"};
+  uformat::fixed_string<8> const side{"buy"};
+  {
+    uformat::deferred_logger target{uformat::overflow::block, 4096, file, file};
+    target.print("px=", 1.25, ' ', name, '=', 100u, " side=", side, " ok=", true,
+                 " id=", int64_t(-42), " view=", std::string_view{"v"});
+    std::vector<std::thread> producers;
+    for(int i = 0; i != 4; ++i)
+      producers.emplace_back([&target, i] {
+        for(int j = 0; j != 1000; ++j)
+          target.print("producer ", i, " line ", j);
+      });
+    for(auto& producer: producers)
+      producer.join();
+  }
+  std::rewind(file);
+  char buffer[256];
+  REQUIRE(std::fgets(buffer, sizeof(buffer), file) != nullptr);
+  REQUIRE(std::string{buffer} == "px=1.250000 qty=100 side=buy ok=true id=-42 view=v\n");
+  int lines = 0;
+  int last[4] = {-1, -1, -1, -1};
+  bool ordered = true;
+  while(std::fgets(buffer, sizeof(buffer), file)) {
+    int producer = 0, line = 0;
+    ordered = ordered && std::sscanf(buffer, "producer %d line %d", &producer, &line) == 2
+      && line == last[producer] + 1;
+    last[producer] = line;
+    ++lines;
+  }
+  std::fclose(file);
+  REQUIRE(lines == 4000);
+  REQUIRE(ordered);
+}
+
+
+TEST_CASE("deferred_logger::print drops record longer than half of queue") {
+  std::FILE* file = std::tmpfile();
+  REQUIRE(file != nullptr);
+  {
+    uformat::deferred_logger target{uformat::overflow::block, 4096, file, file};
+    REQUIRE(target.print("small"));
+    REQUIRE(target.print(std::string(1500, 'y')));
+    REQUIRE(!target.print(std::string(3000, 'x')));
+    REQUIRE(target.print("after"));
+  }
+  std::rewind(file);
+  std::string content(8192, '\0');
+  content.resize(std::fread(content.data(), 1, content.size(), file));
+  std::fclose(file);
+  REQUIRE(content == "small\n" + std::string(1500, 'y') + "\nafter\n");
+}
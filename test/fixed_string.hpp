@@ -29,3 +29,101 @@ TEST_CASE("operator << (ostream, fixed_string)") {
   ss << target;
   REQUIRE(ss.str() == "test");
 }
+
+
+TEST_CASE("fixed_string::find") {
+  uformat::string target("key=value;key2=value2;");
+  REQUIRE(target.find('=') == 3);
+  REQUIRE(target.find('=', 4) == 14);
+  REQUIRE(target.rfind('=') == 14);
+  REQUIRE(target.rfind('=', 13) == 3);
+  REQUIRE(target.find("key2") == 10);
+  REQUIRE(target.find("key3") == uformat::string::npos);
+  REQUIRE(target.find_first_of(";=") == 3);
+  REQUIRE(target.find_first_not_of("key") == 3);
+  REQUIRE(target.find_last_of(';') == target.size() - 1);
+  REQUIRE(uformat::string{}.find_last_of(';') == uformat::string::npos);
+}
+
+
+TEST_CASE("hash<fixed_string>") {
+  std::hash<uformat::short_string> const hash;
+  REQUIRE(hash(uformat::short_string{"BTCUSDT"}) == hash(uformat::short_string{"BTCUSDT"}));
+  REQUIRE(hash(uformat::short_string{"BTCUSDT"}) != hash(uformat::short_string{"ETHUSDT"}));
+  char const zeros[] = {'a', '\0', 'b'};
+  REQUIRE(hash(uformat::short_string{zeros, zeros + 1}) != hash(uformat::short_string{zeros, zeros + 3}));
+  std::string const text(60, 'x');
+  REQUIRE(hash(uformat::short_string{text}) != hash(uformat::short_string{text.substr(1)}));
+}
+
+
+TEST_CASE("hashed_fixed_string::hash") {
+  uformat::hashed_fixed_string<62> target{std::string_view{"BTC"}};
+  target += "USDT";
+  REQUIRE(target.view() == "BTCUSDT");
+  REQUIRE(target.hash() == std::hash<uformat::short_string>{}(uformat::short_string{"BTCUSDT"}));
+  target.pop_back();
+  REQUIRE(target == uformat::hashed_fixed_string<62>{std::string_view{"BTCUSD"}});
+  target.clear();
+  REQUIRE(target == uformat::hashed_fixed_string<62>{});
+}
+
+
+TEST_CASE("fixed_string::operator <=>") {
+  uformat::short_string const ab("ab");
+  uformat::string const abc("abc");
+  REQUIRE(ab < abc);
+  REQUIRE(abc > ab);
+  REQUIRE(ab != abc);
+  REQUIRE(ab == uformat::string{"ab"});
+  REQUIRE(ab.compare(abc) == -1);
+  REQUIRE(abc.compare(ab) == 1);
+  REQUIRE(ab == std::string{"ab"});
+  REQUIRE(std::string{"abc"} > ab);
+  REQUIRE(std::string_view{"aa"} < ab);
+  REQUIRE(ab <= "ab");
+  REQUIRE("b" > ab);
+  REQUIRE(uformat::string{} == nullptr);
+  char const zeros[] = {'a', '\0', 'b'};
+  REQUIRE(uformat::string{zeros, zeros + 3} > uformat::string{zeros, zeros + 1});
+}
+
+
+namespace {
+
+  template<uformat::fixed_string Name>
+  constexpr std::string_view field_name() { return Name.view(); }
+
+} // namespace
+
+
+TEST_CASE("fixed_string is constexpr") {
+  constexpr auto header = [] {
+    uformat::fixed_string<32> s{"px"};
+    s += ',';
+    s.append(std::string_view{"qty"});
+    s.push_back(',');
+    s += "side";
+    return s;
+  }();
+  static_assert(header.view() == "px,qty,side");
+  static_assert(header == "px,qty,side");
+  static_assert(header > uformat::short_string{"px,q"});
+  static_assert(header.find("qty") == 3);
+  static_assert(header.rfind(',') == 6);
+  static_assert(header.find_first_not_of("pqx,") == 4);
+  static_assert(std::hash<uformat::fixed_string<32>>{}(header) != 0);
+  REQUIRE(std::hash<uformat::fixed_string<32>>{}(header) ==
+          std::hash<uformat::short_string>{}(uformat::short_string{"px,qty,side"}));
+  static_assert(field_name<"qty">() == "qty");
+  static_assert(std::is_same_v<decltype(uformat::fixed_string{"qty"}), uformat::fixed_string<3>>);
+  REQUIRE(header.find("side") == 7);
+}
+
+
+TEST_CASE("fixed_string from longer array is explicit") {
+  static_assert(std::is_convertible_v<char const (&)[9], uformat::fixed_string<8>>);
+  static_assert(!std::is_convertible_v<char const (&)[20], uformat::fixed_string<8>>);
+  uformat::fixed_string<8> const truncated{"a very long literal"};
+  REQUIRE(truncated == "a very l");
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+
+#include <doctest/doctest.h>
+#include <uformat/texter.hpp>
+
+
+
+TEST_CASE("inline_string::append spills to heap") {
+  uformat::inline_string<16> target{"0123456789"};
+  REQUIRE(target.is_inline());
+  target.append(target.view());
+  REQUIRE(!target.is_inline());
+  REQUIRE(target == "01234567890123456789");
+  REQUIRE(target.data()[target.size()] == '\0');
+  uformat::inline_string<16> moved{std::move(target)};
+  REQUIRE(moved == "01234567890123456789");
+  REQUIRE(target.empty());
+  moved.resize(4);
+  moved.shrink_to_fit();
+  REQUIRE(moved.is_inline());
+  REQUIRE(moved == "0123");
+}
+
+
+TEST_CASE("inline_string::texter") {
+  uformat::inline_texter target;
+  target.print("order ", 1500, " px=", 1.25);
+  REQUIRE(target.string().is_inline());
+  REQUIRE(target.string() == "order 1500 px=1.250000");
+  std::string expected{target.string().view()};
+  for(int i = 0; i != 100; ++i) {
+    target.print(' ', i);
+    expected += ' ' + std::to_string(i);
+  }
+  REQUIRE(!target.string().is_inline());
+  REQUIRE(target.string() == expected);
+}
@@ -0,0 +1,111 @@
+/* This file is part of uformat library
+ * Copyright 2020 Andrei Ilin <ortfero@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+
+#if !defined(_WIN32)
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <doctest/doctest.h>
+#include <uformat/print.hpp>
+
+
+namespace {
+
+  // Descriptor 1 is pointed to pipe while f runs and until expected count
+  // of lines arrives, deferred print writes them from background thread
+  template<typename F>
+  std::string capture_stdout(size_t expected, F&& f) {
+    std::fflush(stdout);
+    int pipe_descriptors[2];
+    if(pipe(pipe_descriptors) != 0)
+      return {};
+    int const saved = dup(1);
+    dup2(pipe_descriptors[1], 1);
+    f();
+    std::string captured;
+    size_t lines = 0;
+    char buffer[4096];
+    while(lines < expected) {
+      pollfd ready{pipe_descriptors[0], POLLIN, 0};
+      if(poll(&ready, 1, 5000) <= 0)
+        break;
+      auto const n = read(pipe_descriptors[0], buffer, sizeof(buffer));
+      if(n <= 0)
+        break;
+      for(auto i = 0; i != n; ++i)
+        lines += buffer[i] == '\n';
+      captured.append(buffer, size_t(n));
+    }
+    dup2(saved, 1);
+    close(saved);
+    close(pipe_descriptors[0]);
+    close(pipe_descriptors[1]);
+    return captured;
+  }
+
+}
+
+
+TEST_CASE("print writes whole lines") {
+  auto const captured = capture_stdout(401, [] {
+    std::vector<std::thread> producers;
+    for(int i = 0; i != 4; ++i)
+      producers.emplace_back([i] {
+        for(int j = 0; j != 100; ++j)
+          uformat::print("producer ", i, " line ", j, " px=", 1.25 * j);
+      });
+    for(auto& producer: producers)
+      producer.join();
+    uformat::print("done");
+  });
+  std::vector<std::string> lines;
+  for(size_t b = 0, e; (e = captured.find('\n', b)) != std::string::npos; b = e + 1)
+    lines.push_back(captured.substr(b, e - b));
+  REQUIRE(lines.size() == 401);
+  int last[4] = {-1, -1, -1, -1};
+  int done = 0;
+  int complete = 0;
+  for(auto const& line: lines) {
+    int producer = -1, index = -1;
+    double px = -1.0;
+    if(line == "done") {
+      ++done;
+      continue;
+    }
+    if(std::sscanf(line.c_str(), "producer %d line %d px=%lf", &producer, &index, &px) == 3
+       && producer >= 0 && producer < 4 && index == last[producer] + 1 && px == 1.25 * index) {
+      last[producer] = index;
+      ++complete;
+    }
+  }
+  REQUIRE(done == 1);
+  REQUIRE(complete == 400);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+
+#include <doctest/doctest.h>
+#include <uformat/texter.hpp>
+
+
+
+TEST_CASE("ring_string::consume") {
+  uformat::ring_string<65536> target;
+  REQUIRE(target.empty());
+  REQUIRE(target.data()[0] == '\0');
+  target.append(std::string(60000, 'a'));
+  target.consume(60000);
+  REQUIRE(target.empty());
+  std::string chunk;
+  for(int i = 0; i != 10000; ++i)
+    chunk.push_back(char('a' + i % 26));
+  target.append(chunk);
+  REQUIRE(target.view() == chunk);
+  REQUIRE(target.data()[target.size()] == '\0');
+  target.append(std::string(65536 - 10000, 'x'));
+  REQUIRE(target.size() == 10000);
+  REQUIRE(target.push_back('x'));
+  target.consume(5000);
+  REQUIRE(target.view().substr(0, 5000) == chunk.substr(5000));
+}
+
+
+TEST_CASE("ring_string::texter") {
+  uformat::texter<uformat::ring_string<65536>> target;
+  for(int i = 0; i != 10000; ++i) {
+    target.print("line ", i, '\n');
+    if(target.size() > 32768)
+      target.string().consume(target.size());
+  }
+  auto const tail = target.string().view();
+  REQUIRE(tail.substr(tail.size() - 10) == "line 9999\n");
+  target.clear();
+  REQUIRE(target.empty());
+}
+
+
+TEST_CASE("ring_string smaller than page") {
+  uformat::texter<uformat::ring_string<1024>> target;
+  REQUIRE(target.string().valid());
+  REQUIRE(target.capacity() == 1023);
+  for(int i = 0; i != 1000; ++i) {
+    target.print("line ", i, '\n');
+    if(target.size() > 512)
+      target.string().consume(target.size());
+  }
+  auto const tail = target.string().view();
+  REQUIRE(tail.substr(tail.size() - 9) == "line 999\n");
+  REQUIRE(target.data()[target.size()] == '\0');
+  auto const size = target.size();
+  target << std::string(2000, 'x');
+  REQUIRE(target.size() == size);
+  target << 42;
+  target.clear();
+  REQUIRE(target.empty());
+}
+
+
+TEST_CASE("ring_string without mapping") {
+  uformat::texter<uformat::ring_string<65536>> source;
+  source << 42;
+  uformat::texter<uformat::ring_string<65536>> target{std::move(source)};
+  REQUIRE(target.string().view() == "42");
+  REQUIRE_FALSE(source.string().valid());
+  source << 42 << "text";
+  source.print("order ", 1500, '\n');
+  REQUIRE(source.empty());
+  REQUIRE_FALSE(source.string().push_back('x'));
+  REQUIRE_FALSE(source.string().resize(10));
+  source.string().append("text");
+  source.string().consume(10);
+  source.string().pop_back();
+  source.clear();
+  REQUIRE(source.empty());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+
+#include <doctest/doctest.h>
+#include <uformat/texter.hpp>
+#include <string>
+
+
+
+TEST_CASE("rope_string::append") {
+  uformat::rope_string<16> target;
+  REQUIRE(target.empty());
+  REQUIRE(target.segments_count() == 0);
+  std::string expected;
+  for(int i = 0; i != 10; ++i)
+    expected += "0123456789";
+  target.append(expected);
+  REQUIRE(target == expected);
+  REQUIRE(target.segments_count() == 7);
+  REQUIRE(target[95] == '5');
+  std::size_t total = 0;
+  for(std::size_t i = 0; i != target.segments_count(); ++i)
+    total += target.segments()[i].iov_len;
+  REQUIRE(total == target.size());
+}
+
+
+TEST_CASE("rope_string::clear reuses chunks") {
+  uformat::chunk_pool<16> pool;
+  uformat::rope_string<16> target{pool};
+  target.append(std::string(100, 'x'));
+  target.clear();
+  REQUIRE(target.empty());
+  REQUIRE(target.segments_count() == 1);
+  REQUIRE(pool.size() == 6);
+  target.append(std::string(40, 'y'));
+  REQUIRE(pool.size() == 4);
+  REQUIRE(target == std::string(40, 'y'));
+  uformat::rope_string<16> moved{std::move(target)};
+  REQUIRE(moved == std::string(40, 'y'));
+  REQUIRE(target.empty());
+}
+
+
+TEST_CASE("rope_string::texter") {
+  uformat::texter<uformat::rope_string<16>> target;
+  uformat::dynamic_texter expected;
+  for(int i = 0; i != 100; ++i) {
+    target.print("px=", -1.25 * i, ' ');
+    target.right(8, i) << '\n';
+    expected.print("px=", -1.25 * i, ' ');
+    expected.right(8, i) << '\n';
+  }
+  REQUIRE(target.size() == expected.size());
+  REQUIRE(target.string() == expected.string());
+  target << std::string(40, 'z');
+  expected << std::string(40, 'z');
+  REQUIRE(target.string() == expected.string());
+}
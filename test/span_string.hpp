@@ -0,0 +1,64 @@
+#pragma once
+
+
+#include <doctest/doctest.h>
+#include <uformat/texter.hpp>
+
+
+
+TEST_CASE("span_string::append reports truncation") {
+  char region[8] = {'-', '-', '-', '-', '-', '-', '-', '-'};
+  uformat::span_string target{region, 6};
+  target.append("0123");
+  REQUIRE(target == "0123");
+  REQUIRE(!target.truncated());
+  target.append("456");
+  REQUIRE(target == "0123");
+  REQUIRE(target.truncated());
+  REQUIRE(target.push_back('4'));
+  REQUIRE(target.push_back('5'));
+  REQUIRE(!target.push_back('6'));
+  REQUIRE(std::string_view{region, 8} == "012345--");
+  target.clear();
+  REQUIRE(!target.truncated());
+}
+
+
+TEST_CASE("span_string::texter") {
+  char slot[24];
+  uformat::span_texter target{slot, sizeof(slot)};
+  target.print("order ", 1500, " qty=", 100u);
+  REQUIRE(target.data() == slot);
+  REQUIRE(target.string() == "order 1500 qty=100");
+  REQUIRE(!target.string().truncated());
+  target << -127562;
+  REQUIRE(target.string() == "order 1500 qty=100");
+  REQUIRE(target.string().truncated());
+  char next[64];
+  target.string().reset(next, sizeof(next));
+  target << -127562;
+  REQUIRE(target.string() == "-127562");
+  REQUIRE(!target.string().truncated());
+}
+
+
+TEST_CASE("span_string::texter(double)") {
+  char slot[32];
+  uformat::span_texter target{slot, sizeof(slot)};
+  target.print("px=", 1.5);
+  REQUIRE(target.string() == "px=1.500000");
+  REQUIRE(!target.string().truncated());
+  target.shortest(0.1);
+  REQUIRE(target.string() == "px=1.5000000.1");
+  target << 1.7e18;
+  REQUIRE(target.string() == "px=1.5000000.1");
+  REQUIRE(target.string().truncated());
+  char tiny[4];
+  target.string().reset(tiny, sizeof(tiny));
+  target.print(-1.5e300);
+  REQUIRE(target.string().truncated());
+  target.string().reset(tiny, sizeof(tiny));
+  target.shortest(2.5);
+  REQUIRE(target.string() == "2.5");
+  REQUIRE(!target.string().truncated());
+}
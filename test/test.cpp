@@ -1,9 +1,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_NO_POSIX_SIGNALS
 #include <doctest/doctest.h>
 
 #include "fixed_string.hpp"
 #include "continuous_string.hpp"
+#include "ring_string.hpp"
+#include "inline_string.hpp"
+#include "span_string.hpp"
+#include "rope_string.hpp"
 #include "texter.hpp"
+#include "async_logger.hpp"
+#include "deferred_logger.hpp"
+#include "print.hpp"
 
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <cstdlib>
 #include <doctest/doctest.h>
 #include <uformat/texter.hpp>
 
@@ -57,6 +58,77 @@ TEST_CASE("texter::print(int)") {
 }
 
 
+TEST_CASE("texter::print(int64_t)") {
+  uformat::dynamic_texter target;
+  target << int64_t(-9223372036854775807 - 1) << ' ' << uint64_t(18446744073709551615u)
+         << ' ' << int32_t(-2147483647 - 1) << ' ' << 0u << ' ' << uint64_t(10000000000);
+  REQUIRE(target.string() ==
+          "-9223372036854775808 18446744073709551615 -2147483648 0 10000000000");
+}
+
+
+TEST_CASE("texter::print(int64_t) round trip") {
+  uformat::dynamic_texter target;
+  uint64_t x = 0x9E3779B97F4A7C15ull;
+  for(int i = 0; i != 100000; ++i) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    int64_t const value = int64_t(x) >> (x % 64);
+    uint32_t const small = uint32_t(x >> (x % 32));
+    target.clear();
+    target.print(value, ' ', small);
+    char* end = nullptr;
+    REQUIRE(std::strtoll(target.data(), &end, 10) == value);
+    REQUIRE(std::strtoul(end, nullptr, 10) == small);
+  }
+}
+
+
+TEST_CASE("texter::fixed(int)") {
+  uformat::dynamic_texter target;
+  target.fixed(42u, 5);
+  REQUIRE(target.string() == "00042");
+  target.clear();
+  target.fixed(-5, 3);
+  REQUIRE(target.string() == "-05");
+  target.clear();
+  target.fixed(int64_t(123456), 3);
+  REQUIRE(target.string() == "123456");
+}
+
+
+TEST_CASE("texter::print(...)") {
+  uformat::fixed_texter target;
+  std::string const name{"qty"};
+  target.print(name, '=', 1500u, ", px=", 1.25, ", ok=", false, ' ', int64_t(-9223372036854775807 - 1));
+  REQUIRE(target.string() == "qty=1500, px=1.250000, ok=false -9223372036854775808");
+  uformat::texter<uformat::fixed_string<68>> bounded;
+  bounded.print("01234567890123456789", 1.5, 2.5);
+  REQUIRE(bounded.string() == "012345678901234567891.5000002.500000");
+}
+
+
+TEST_CASE("texter::print(double) grows dynamic_texter") {
+  uformat::dynamic_texter target;
+  std::string expected;
+  for(int i = 0; i != 64; ++i) {
+    target.print(-1.5, ' ');
+    expected += "-1.500000 ";
+  }
+  REQUIRE(target.string() == expected);
+  REQUIRE(target.data()[target.size()] == '\0');
+}
+
+
+TEST_CASE("texter::print(char const*...)") {
+  uformat::dynamic_texter target;
+  char buffer[16] = "side";
+  char const* const name = "qty";
+  char const* const missing = nullptr;
+  target.print(buffer, '=', 'B', ' ', name, '=', 100u, missing, '.');
+  REQUIRE(target.string() == "side=B qty=100.");
+}
+
+
 TEST_CASE("texter::quoted") {
   uformat::dynamic_texter target;
   target.quoted(127562);
@@ -111,3 +183,112 @@ TEST_CASE("texter::right/2") {
   target.right(2, -10);
   REQUIRE(target.string() == "-10");
 }
+
+
+TEST_CASE("texter::shortest(double)") {
+  uformat::dynamic_texter target;
+  target.shortest(-127562.127562);
+  REQUIRE(target.string() == "-127562.127562");
+  target.clear();
+  target.shortest(0.1);
+  REQUIRE(target.string() == "0.1");
+  target.clear();
+  target.shortest(100.);
+  REQUIRE(target.string() == "100");
+  target.clear();
+  target.shortest(0.000001);
+  REQUIRE(target.string() == "0.000001");
+  target.clear();
+  target.shortest(1e-7);
+  REQUIRE(target.string() == "1e-7");
+  target.clear();
+  target.shortest(1.5e300);
+  REQUIRE(target.string() == "1.5e+300");
+  target.clear();
+  target.shortest(5e-324);
+  REQUIRE(target.string() == "5e-324");
+  target.clear();
+  target.shortest(0.);
+  REQUIRE(target.string() == "0");
+}
+
+
+TEST_CASE("texter::shortest(float)") {
+  uformat::dynamic_texter target;
+  target.shortest(0.1f);
+  REQUIRE(target.string() == "0.1");
+  target.clear();
+  target.shortest(-3.4028235e38f);
+  REQUIRE(target.string() == "-3.4028235e+38");
+}
+
+
+TEST_CASE("texter::fixed(double)") {
+  uformat::dynamic_texter target;
+  target.fixed(1.05, 6);
+  REQUIRE(target.string() == "1.050000");
+  target.clear();
+  target.fixed(0.9999999, 6);
+  REQUIRE(target.string() == "1.000000");
+  target.clear();
+  target.fixed(2.5, 0);
+  REQUIRE(target.string() == "2");
+  target.clear();
+  target.fixed(0.125, 2);
+  REQUIRE(target.string() == "0.12");
+  target.clear();
+  target.fixed(0.0001, 3);
+  REQUIRE(target.string() == "0.000");
+  target.clear();
+  target.fixed(1e20, 1);
+  REQUIRE(target.string() == "100000000000000000000.0");
+  target.clear();
+  target.fixed(-1.7976931348623157e308, 0);
+  REQUIRE(target.string().size() == 310);
+  REQUIRE(target.string().compare(0, 8, "-1797693") == 0);
+}
+
+
+TEST_CASE("texter::fixed(double) into small fixed_string") {
+  uformat::texter<uformat::fixed_string<32>> target;
+  target << 1.7e18;
+  REQUIRE(target.string() == "1700000000000000000.000000");
+  target.clear();
+  target.print("ts=", 1.7e18);
+  REQUIRE(target.string() == "ts=1700000000000000000.000000");
+  target.clear();
+  target.fixed(-9.9999999, 6);
+  REQUIRE(target.string() == "-10.000000");
+  target.clear();
+  target.print("01234567890123456789012", 1.5);
+  REQUIRE(target.string() == "012345678901234567890121.500000");
+}
+
+
+TEST_CASE("texter::format") {
+  uformat::dynamic_texter target;
+  target.format<"px={:.4f} qty={:>8}|">(1.5, 42);
+  REQUIRE(target.string() == "px=1.5000 qty=      42|");
+  target.clear();
+  target.format<"{{{}}} {:<5}|{:6}|{:05}">("id", 'x', "abc", -42);
+  REQUIRE(target.string() == "{id} x    |abc   |-0042");
+  target.clear();
+  target.format<"{:f} {:>3}">(0.25, true);
+  REQUIRE(target.string() == "0.250000 true");
+  target.clear();
+  target.format<"{:<05}|{:>05}|{:05}|{:<06.2f}">(-42, 7, 7, -1.5);
+  REQUIRE(target.string() == "-42  |    7|00007|-1.50 ");
+}
+
+
+TEST_CASE("texter::format keeps used segments only") {
+  constexpr auto const& parsed = uformat::detail::formatting::parsed<
+    "order {} filled at {:.2f}, ................................................................">;
+  static_assert(parsed.segments_count == 5);
+  static_assert(sizeof(parsed.segments) == 5 * sizeof(uformat::detail::formatting::segment));
+  uformat::dynamic_texter target;
+  target.format<"">();
+  REQUIRE(target.empty());
+  target.format<"order {} filled at {:.2f}, ................................................................">(7, 1.5);
+  REQUIRE(target.string().substr(0, 26) == "order 7 filled at 1.50, ..");
+}